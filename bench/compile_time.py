@@ -0,0 +1,126 @@
+#!/usr/bin/python3
+# Measures how much explicit instantiation saves in build time.
+#
+# It generates translation units which shrink and minimize vectors of
+# integers and spans of bytes, as test binaries do, and compiles them
+# * header-only, where every unit instantiates the shrinkers;
+# * with `SHRINK_EXTERN_TEMPLATES`, where units use the instantiations of
+#   src/shrink/instances.cpp, which is compiled once and counted.
+# Then it prints the wall time and the total object size of both.
+import subprocess as sp
+from pathlib import Path
+import argparse
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+ROOT = Path(__file__).resolve().parent.parent
+
+UNIT = '''\
+#include "shrink/all.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+size_t unit_{index}() {{
+    size_t n = 0;
+    std::vector<int> xs = {{{index}, 60, 7, 80, 9}};
+    n += shrink::minimize(xs, [](const std::vector<int>& xs) {{
+        return xs.size() > {index} % 3;
+    }}).value.size();
+    std::vector<uint8_t> bs = {{1, 2, 3}};
+    for(auto const& c: shrink::shrink(bs)) {{
+        n += c.size();
+    }}
+    std::vector<int64_t> ws = {{{index}, -1}};
+    for(auto const& c: shrink::shrink(ws)) {{
+        n += c.size();
+    }}
+    std::byte raw[4] = {{}};
+    for(auto const& c: shrink::shrink(std::span<const std::byte>(raw))) {{
+        n += c.size();
+    }}
+    return n;
+}}
+'''
+
+def parse_arg():
+    parser = argparse.ArgumentParser(description='measure compile time of shrinkers with and without explicit instantiation.')
+    parser.add_argument('--cxx',
+        dest='cxx',
+        action='store',
+        default='c++',
+        help='The C++ compiler.',
+    )
+    parser.add_argument('--units',
+        dest='units',
+        action='store',
+        type=int,
+        default=32,
+        help='Number of generated translation units.',
+    )
+    parser.add_argument('--jobs',
+        dest='jobs',
+        action='store',
+        type=int,
+        default=1,
+        help='Number of concurrent compilations.',
+    )
+    parser.add_argument('--flags',
+        dest='flags',
+        action='store',
+        default='-O0 -g',
+        help='Compile flags, besides the standard and include directories.',
+    )
+    parser.add_argument('-I',
+        dest='includes',
+        action='append',
+        default=[],
+        help='Extra include directories, searched before the repo. fassert.hpp must be found.',
+    )
+    args = parser.parse_args()
+    return args
+
+def compile_all(args, sources, out_dir, defines):
+    includes = [f'-I{d}' for d in args.includes]
+    includes += [f'-I{ROOT / "src"}', f'-I{ROOT / "deps" / "fancy_assert" / "src"}']
+    def compile_one(src):
+        obj = out_dir / (src.stem + '.o')
+        cmd = [args.cxx, '-std=c++20', '-pthread', '-DENABLE_STD_FORMAT']
+        cmd += args.flags.split() + defines + includes
+        cmd += ['-c', str(src), '-o', str(obj)]
+        sp.check_call(cmd)
+        return obj.stat().st_size
+    start = time.monotonic()
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        size = sum(pool.map(compile_one, sources))
+    return time.monotonic() - start, size
+
+def main():
+    args = parse_arg()
+    with tempfile.TemporaryDirectory() as tmp:
+        tmp = Path(tmp)
+        units = []
+        for i in range(args.units):
+            src = tmp / f'unit_{i}.cpp'
+            src.write_text(UNIT.format(index=i))
+            units.append(src)
+        instances = ROOT / 'src' / 'shrink' / 'instances.cpp'
+        results = []
+        for name, sources, defines in [
+                ('header-only', units, []),
+                ('explicit instantiation', units + [instances], ['-DSHRINK_EXTERN_TEMPLATES'])]:
+            out_dir = tmp / name.replace(' ', '_')
+            out_dir.mkdir()
+            secs, size = compile_all(args, sources, out_dir, defines)
+            results.append((name, secs, size))
+        print(f'{args.units} units, {args.jobs} jobs, flags: {args.flags}')
+        print(f'{"mode":<24}{"seconds":>10}{"objects (KiB)":>16}')
+        for name, secs, size in results:
+            print(f'{name:<24}{secs:>10.2f}{size / 1024:>16.0f}')
+        base = results[0][1]
+        print(f'saved: {(1 - results[1][1] / base) * 100:.1f}% of build time')
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,71 @@
+// Compares walking candidates of the hand-written integer shrinker with
+// walking the same candidates yielded by a coroutine shrinker.
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/coro.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+
+using namespace std;
+
+namespace {
+struct Wrapped {
+    int64_t v = 0;
+};
+}
+
+template<>
+struct shrink::Shrinker<Wrapped> {
+    explicit Shrinker(Wrapped w) noexcept
+    :   _w(w)
+    {}
+
+    auto shrink() && noexcept {
+        return shrink::coroutine_shrinker([w = _w]() -> shrink::Yield<Wrapped> {
+            for(int64_t v: shrink::shrink(w.v)) {
+                co_yield Wrapped {.v = v};
+            }
+        });
+    }
+
+private:
+    Wrapped _w;
+};
+
+namespace {
+constexpr int64_t kShrinks = 1'000'000;
+
+template<class F>
+double seconds(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+}
+
+int main() {
+    // Sums are printed, so the walks are not optimized away.
+    int64_t sum = 0;
+    double hand = seconds([&]() {
+        for(int64_t i = 0; i < kShrinks; ++i) {
+            for(int64_t v: shrink::shrink(i)) {
+                sum += v;
+            }
+        }
+    });
+    int64_t coro_sum = 0;
+    double coro = seconds([&]() {
+        for(int64_t i = 0; i < kShrinks; ++i) {
+            for(Wrapped w: shrink::shrink(Wrapped {.v = i})) {
+                coro_sum += w.v;
+            }
+        }
+    });
+    fputs(format("{:<12} {:>10} {:>12}\n", "shrinker", "seconds", "ns/shrink").c_str(), stdout);
+    fputs(format("{:<12} {:>10.3f} {:>12.1f}\n", "int", hand, hand * 1e9 / kShrinks).c_str(), stdout);
+    fputs(format("{:<12} {:>10.3f} {:>12.1f}\n", "coroutine", coro, coro * 1e9 / kShrinks).c_str(), stdout);
+    fputs(format("ratio: {:.1f}x, sums {}\n", coro / hand, sum == coro_sum ? "agree" : "differ").c_str(), stdout);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Compares wall time of `minimize()` and `minimize_partitioned()` on a batch
+// of independent partitions, with a predicate of a fixed cost.
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/partition.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+// the predicate costs this much on every call.
+constexpr auto kCost = chrono::microseconds(20);
+
+bool pred(const vector<int>& xs) {
+    this_thread::sleep_for(kCost);
+    // every partition `p` of the first 8 needs an element of at least
+    // `p * 1000 + 900`.
+    for(int p = 0; p < 8; ++p) {
+        bool found = ranges::any_of(xs, [&](int x) {
+            return x >= p * 1000 + 900 && x < (p + 1) * 1000;
+        });
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class F>
+double seconds(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+}
+
+int main() {
+    // 32 partitions of 64 elements; the failure needs 8 of them.
+    vector<int> input;
+    for(int i = 0; i < 32 * 64; ++i) {
+        input.push_back(i % 32 * 1000 + i * 37 % 1000);
+    }
+    auto part = [](int x) { return x / 1000; };
+
+    size_t calls = 0;
+    double plain = seconds([&]() {
+        calls = shrink::minimize(input, pred).stats.predicate_calls;
+    });
+    fputs(format("{:<12} {:>8} {:>10}\n", "threads", "calls", "seconds").c_str(), stdout);
+    fputs(format("{:<12} {:>8} {:>10.3f}\n", "minimize", calls, plain).c_str(), stdout);
+    for(size_t threads: {1, 2, 4, 8}) {
+        double t = seconds([&]() {
+            calls = shrink::minimize_partitioned(
+                input,
+                part,
+                pred,
+                shrink::PartitionOptions {.threads = threads}).stats.predicate_calls;
+        });
+        fputs(format("{:<12} {:>8} {:>10.3f}\n", threads, calls, t).c_str(), stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Compares predicate calls of `minimize()`, with the fixed pass order of
+// `ChainShrinker`, with those of `minimize_adaptive()`.
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/schedule.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <format>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace {
+// random values in [0, 900), but the last one of every 100 in [900, 1000).
+vector<int> random_input(size_t n, uint64_t seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> dist(0, 899);
+    vector<int> res(n);
+    ranges::generate(res, [&]() { return dist(rng); });
+    for(size_t i = 99; i < n; i += 100) {
+        res[i] = 900 + dist(rng) % 100;
+    }
+    return res;
+}
+
+struct Workload {
+    string_view name;
+    function<bool(const vector<int>&)> pred;
+};
+
+void run(const Workload& w, const vector<int>& input) {
+    auto fixed = shrink::minimize(input, w.pred);
+    auto adaptive = shrink::minimize_adaptive(input, w.pred);
+    double saving = 100.0
+        * (static_cast<double>(fixed.stats.predicate_calls)
+            - static_cast<double>(adaptive.stats.predicate_calls))
+        / static_cast<double>(fixed.stats.predicate_calls);
+    fputs(
+        format("{:<10} {:>6} {:>12} {:>12} {:>9.1f}% {:>6} {:>6}\n",
+            w.name,
+            input.size(),
+            fixed.stats.predicate_calls,
+            adaptive.stats.predicate_calls,
+            saving,
+            fixed.value.size(),
+            adaptive.value.size()).c_str(),
+        stdout);
+}
+}
+
+int main() {
+    vector<Workload> workloads = {
+        {
+            "needle",
+            [](const vector<int>& xs) {
+                return ranges::any_of(xs, [](int x) { return x >= 900; });
+            },
+        },
+        {
+            "pair",
+            [](const vector<int>& xs) {
+                auto it = ranges::find_if(xs, [](int x) { return x < 100; });
+                return it != xs.end()
+                    && any_of(it, xs.end(), [](int x) { return x >= 900; });
+            },
+        },
+        {
+            "many",
+            [](const vector<int>& xs) {
+                return ranges::count_if(xs, [](int x) { return x >= 500; }) >= 20;
+            },
+        },
+        {
+            "sum",
+            [](const vector<int>& xs) {
+                return accumulate(xs.begin(), xs.end(), 0) >= 5000;
+            },
+        },
+    };
+    fputs(
+        format("{:<10} {:>6} {:>12} {:>12} {:>10} {:>6} {:>6}\n",
+            "workload", "input", "fixed calls", "adapt calls", "saving",
+            "fixed", "adapt").c_str(),
+        stdout);
+    for(size_t n: {100, 1000}) {
+        auto input = random_input(n, n);
+        for(auto const& w: workloads) {
+            run(w, input);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+// Traces `minimize()` of nested vectors, and writes the Chrome trace to
+// `trace.json` in the working directory, which Perfetto opens.
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/trace.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+SHRINK_TRACE_ALLOCATIONS()
+
+int main() {
+    mt19937_64 rng(0);
+    uniform_int_distribution<int> dist(0, 999);
+    vector<vector<int>> input(50);
+    for(auto& xs: input) {
+        xs.resize(20);
+        ranges::generate(xs, [&]() { return dist(rng); });
+    }
+    auto pred = [](const vector<vector<int>>& xss) {
+        return ranges::count_if(xss, [](const vector<int>& xs) {
+            return ranges::any_of(xs, [](int x) { return x >= 990; });
+        }) >= 2;
+    };
+
+    shrink::RecordingTracer tracer;
+    auto res = shrink::minimize(input, pred, shrink::MinimizeOptions {}, tracer);
+    fputs(tracer.summary_table().c_str(), stdout);
+    printf("predicate calls: %zu, accepted: %zu\n",
+        res.stats.predicate_calls, res.stats.accepted);
+
+    ofstream out("trace.json");
+    out << tracer.chrome_trace();
+    return 0;
+}
@@ -0,0 +1,353 @@
+#pragma once
+#include "core.hpp"
+#include "fassert.hpp"
+#include <concepts>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Adaptors over shrinker ranges, e.g., in order to keep invariants of
+// candidates before they reach a predicate.
+// * `filter(r, pred)` keeps candidates `v` of `r` where `pred(v)` holds.
+// * `prefilter(r, pred)` keeps candidates of `r` at iterators `it` where
+//   `pred(it)` holds. `pred` can inspect the position of a candidate, e.g.,
+//   `it.hole()` or `it.index()` of vector shrinkers, so rejected candidates
+//   are never materialized.
+// * `map(r, f)` turns candidates `v` into `f(v)`.
+// * `filter_map(r, f)` turns candidates `v` into `*f(v)`, dropping those where
+//   `f(v)` is empty.
+//
+// Like `ChainShrinker`, an adaptor owns its underlying range, and its
+// iterators must not outlive it.
+
+namespace shrink {
+
+namespace _impl_adaptor {
+
+template<class R, class F>
+struct FilterMapShrinker {
+    using BaseIter = std::ranges::iterator_t<const R>;
+    using Mapped = std::invoke_result_t<const F&, std::ranges::range_value_t<R>>;
+
+    struct Iter {
+        using value_type = typename Mapped::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(BaseIter it, BaseIter end, const F* f) noexcept
+        :   _it(std::move(it)),
+            _end(std::move(end)),
+            _f(f)
+        {
+            _settle();
+        }
+
+        value_type operator*() const noexcept {
+            FASSERT(_cached);
+            return *_cached;
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_it != _end);
+            ++_it;
+            _settle();
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _it == ano._it;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        // steps to the first candidate which `_f` keeps.
+        // A kept candidate is cached, so it is materialized only once.
+        void _settle() noexcept {
+            _cached.reset();
+            for(; _it != _end; ++_it) {
+                _cached = std::invoke(*_f, *_it);
+                if (_cached) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        BaseIter _it;
+        BaseIter _end;
+        const F* _f = nullptr;
+        Mapped _cached;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(_base.begin(), _base.end(), &_f);
+    }
+
+    Iter end() const noexcept {
+        return Iter(_base.end(), _base.end(), &_f);
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+    explicit FilterMapShrinker(R base, F f) noexcept
+    :   _base(std::move(base)),
+        _f(std::move(f))
+    {}
+
+private:
+    R _base;
+    F _f;
+};
+
+template<class R, class Pred>
+struct PrefilterShrinker {
+    using BaseIter = std::ranges::iterator_t<const R>;
+
+    struct Iter {
+        using value_type = std::ranges::range_value_t<R>;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(BaseIter it, BaseIter end, const Pred* pred) noexcept
+        :   _it(std::move(it)),
+            _end(std::move(end)),
+            _pred(pred)
+        {
+            _settle();
+        }
+
+        value_type operator*() const noexcept {
+            FASSERT(_it != _end);
+            return *_it;
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_it != _end);
+            ++_it;
+            _settle();
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        // the underlying iterator, e.g., to inspect the position of the
+        // current candidate.
+        const BaseIter& base() const noexcept {
+            return _it;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _it == ano._it;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        void _settle() noexcept {
+            for(; _it != _end; ++_it) {
+                if (std::invoke(*_pred, std::as_const(_it))) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        BaseIter _it;
+        BaseIter _end;
+        const Pred* _pred = nullptr;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(_base.begin(), _base.end(), &_pred);
+    }
+
+    Iter end() const noexcept {
+        return Iter(_base.end(), _base.end(), &_pred);
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+    explicit PrefilterShrinker(R base, Pred pred) noexcept
+    :   _base(std::move(base)),
+        _pred(std::move(pred))
+    {}
+
+private:
+    R _base;
+    Pred _pred;
+};
+
+template<class R, class F>
+struct MapShrinker {
+    using BaseIter = std::ranges::iterator_t<const R>;
+
+    struct Iter {
+        using value_type = std::remove_cvref_t<
+            std::invoke_result_t<const F&, std::ranges::range_value_t<R>>>;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(BaseIter it, const F* f) noexcept
+        :   _it(std::move(it)),
+            _f(f)
+        {}
+
+        value_type operator*() const noexcept {
+            return std::invoke(*_f, *_it);
+        }
+
+        Iter& operator++() noexcept {
+            ++_it;
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        const BaseIter& base() const noexcept {
+            return _it;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _it == ano._it;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        BaseIter _it;
+        const F* _f = nullptr;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(_base.begin(), &_f);
+    }
+
+    Iter end() const noexcept {
+        return Iter(_base.end(), &_f);
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+    explicit MapShrinker(R base, F f) noexcept
+    :   _base(std::move(base)),
+        _f(std::move(f))
+    {}
+
+private:
+    R _base;
+    F _f;
+};
+
+template<class T>
+struct is_optional : std::false_type {};
+
+template<class T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+}
+
+template<std::ranges::forward_range R, class F>
+requires _impl_adaptor::is_optional<
+    std::invoke_result_t<const F&, std::ranges::range_value_t<R>>>::value
+auto filter_map(R base, F f) noexcept {
+    return _impl_adaptor::FilterMapShrinker<R, F>(std::move(base), std::move(f));
+}
+
+template<std::ranges::forward_range R, class Pred>
+requires std::predicate<const Pred&, const std::ranges::range_value_t<R>&>
+auto filter(R base, Pred pred) noexcept {
+    using V = std::ranges::range_value_t<R>;
+    return filter_map(
+        std::move(base),
+        [pred = std::move(pred)](V v) noexcept -> std::optional<V> {
+            if (!std::invoke(pred, std::as_const(v))) {
+                return std::nullopt;
+            }
+            return std::optional<V>(std::move(v));
+        });
+}
+
+template<std::ranges::forward_range R, class Pred>
+requires std::predicate<const Pred&, const std::ranges::iterator_t<const R>&>
+auto prefilter(R base, Pred pred) noexcept {
+    return _impl_adaptor::PrefilterShrinker<R, Pred>(std::move(base), std::move(pred));
+}
+
+template<std::ranges::forward_range R, class F>
+requires std::invocable<const F&, std::ranges::range_value_t<R>>
+auto map(R base, F f) noexcept {
+    return _impl_adaptor::MapShrinker<R, F>(std::move(base), std::move(f));
+}
+
+}
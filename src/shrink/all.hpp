@@ -2,6 +2,26 @@
 
 #include "core.hpp"
 #include "int.hpp"
+#include "float.hpp"
 #include "vec.hpp"
+#include "passes.hpp"
 #include "span.hpp"
+#include "extents.hpp"
+#include "array.hpp"
+#include "text.hpp"
+#include "minimize.hpp"
+#include "corpus.hpp"
+#include "runner.hpp"
+#include "adaptor.hpp"
+#include "schedule.hpp"
+#include "partition.hpp"
+#include "block.hpp"
+#include "cost.hpp"
+#include "coverage.hpp"
+#include "pipeline.hpp"
+#include "async.hpp"
+#include "coro.hpp"
+#include "signature.hpp"
+#include "wide.hpp"
+#include "trace.hpp"
 
@@ -0,0 +1,193 @@
+#pragma once
+#include "core.hpp"
+#include "fassert.hpp"
+#include <array>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+// `std::array<T, N>` keeps its length, and shrinks its elements one by one,
+// from the first one, like `ElemShrinker` of vectors.
+//
+// Shrinkers of all elements are built, by a pack expansion over the indices,
+// into the array shrinker itself, so shrinking an array allocates nothing
+// unless shrinking its elements does.
+// Like `ChainShrinker`, iterators must not outlive the shrinker, nor survive
+// moving it.
+
+namespace shrink {
+
+namespace _impl_array {
+
+template<Shrinkable T, size_t N>
+struct Shrinker {
+    using ElemShrinker = std::invoke_result_t<decltype(shrink<T>), T>;
+    using ElemIter = std::ranges::iterator_t<const ElemShrinker>;
+
+    struct Iter {
+        using value_type = std::array<T, N>;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(const Shrinker* owner) noexcept
+        :   _owner(owner),
+            _index(0)
+        {
+            if constexpr (N > 0) {
+                _it = std::ranges::begin(_owner->_elems[0]);
+                _settle();
+            }
+        }
+
+        value_type operator*() const noexcept {
+            FASSERT(_index < N);
+            value_type res = _owner->_xs;
+            res[_index] = *_it;
+            return res;
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_index < N);
+            ++_it;
+            _settle();
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        // the index of the element which the current candidate shrinks.
+        size_t index() const noexcept {
+            return _index;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            if (_index != ano._index) {
+                return false;
+            }
+            return _index == N || (_owner == ano._owner && _it == ano._it);
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        // steps over elements which have no more candidates.
+        void _settle() noexcept {
+            while (_it == std::ranges::end(_owner->_elems[_index])) {
+                ++_index;
+                if (_index == N) {
+                    _it = ElemIter();
+                    return;
+                }
+                _it = std::ranges::begin(_owner->_elems[_index]);
+            }
+        }
+
+    private:
+        const Shrinker* _owner = nullptr;
+        size_t _index = N;
+        ElemIter _it;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(this);
+    }
+
+    Iter end() const noexcept {
+        return Iter();
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+    explicit Shrinker(std::array<T, N> xs) noexcept
+    :   _xs(std::move(xs)),
+        _elems(_make_elems(_xs, std::make_index_sequence<N>()))
+    {}
+
+private:
+    template<size_t... Is>
+    static std::array<ElemShrinker, N> _make_elems(
+        const std::array<T, N>& xs,
+        std::index_sequence<Is...>) noexcept
+    {
+        return {shrink(xs[Is])...};
+    }
+
+private:
+    std::array<T, N> _xs;
+    std::array<ElemShrinker, N> _elems;
+};
+
+}
+
+template<Shrinkable T, size_t N>
+struct Shrinker<std::array<T, N>> {
+    explicit Shrinker(std::array<T, N> xs) noexcept
+    :   _xs(std::move(xs))
+    {}
+
+    _impl_array::Shrinker<T, N> shrink() && noexcept {
+        return _impl_array::Shrinker<T, N>(std::move(_xs));
+    }
+
+private:
+    std::array<T, N> _xs;
+};
+
+template<Serializable T, size_t N>
+struct Serializer<std::array<T, N>> {
+    // The length is part of the type, so it is not written.
+    static void write(std::vector<std::byte>& out, const std::array<T, N>& xs) noexcept {
+        for(const T& x: xs) {
+            Serializer<T>::write(out, x);
+        }
+    }
+
+    static std::optional<std::array<T, N>> read(std::span<const std::byte>& in) noexcept {
+        std::array<std::optional<T>, N> xs;
+        for(auto& x: xs) {
+            x = Serializer<T>::read(in);
+            if (!x) {
+                return std::nullopt;
+            }
+        }
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return std::array<T, N> {std::move(*xs[Is])...};
+        }(std::make_index_sequence<N>());
+    }
+};
+
+template<Generatable T, size_t N>
+struct Generator<std::array<T, N>> {
+    static std::array<T, N> generate(Random& rng, size_t size) noexcept {
+        // Elements of a braced list are generated in order.
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return std::array<T, N> {((void)Is, Generator<T>::generate(rng, size))...};
+        }(std::make_index_sequence<N>());
+    }
+};
+
+}
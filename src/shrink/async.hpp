@@ -0,0 +1,405 @@
+#pragma once
+#include "core.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+// Minimization with asynchronous predicates, e.g., those which submit a
+// request to a server and wait for its response.
+//
+// A predicate is a coroutine returning `Task<bool>`. It takes a candidate
+// and, optionally, a `std::stop_token` which is requested to stop when its
+// result is no longer wanted.
+// `minimize_async()` keeps up to `in_flight` candidates under evaluation on
+// an `EventLoop`, which runs on the calling thread. Results are committed
+// in the order of candidates, so the result, and the sequence of accepted
+// candidates, are those of `minimize()`. When a candidate is accepted, all
+// later ones in flight are cancelled.
+//
+// Predicates resume on the loop. An awaitable which waits for something on
+// another thread, e.g., a response, hands its coroutine handle to that
+// thread, which resumes it by `EventLoop::post()`.
+
+namespace shrink {
+
+template<class T>
+class Task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        auto final_suspend() noexcept {
+            struct Awaiter {
+                bool await_ready() noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(
+                    std::coroutine_handle<promise_type> h) noexcept
+                {
+                    auto next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+            return Awaiter {};
+        }
+
+        template<class U>
+        requires std::convertible_to<U, T>
+        void return_value(U&& v) noexcept {
+            value.emplace(std::forward<U>(v));
+        }
+
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& ano) noexcept
+    :   _h(std::exchange(ano._h, {}))
+    {}
+
+    Task& operator=(Task&& ano) noexcept {
+        if (this != &ano) {
+            _destroy();
+            _h = std::exchange(ano._h, {});
+        }
+        return *this;
+    }
+
+    ~Task() {
+        _destroy();
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    // starts the task, which resumes the awaiting coroutine when it is done.
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        _h.promise().continuation = awaiting;
+        return _h;
+    }
+
+    T await_resume() noexcept {
+        FASSERT(_h.promise().value);
+        return std::move(*_h.promise().value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) noexcept
+    :   _h(h)
+    {}
+
+    void _destroy() noexcept {
+        if (_h) {
+            _h.destroy();
+            _h = {};
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> _h;
+};
+
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop() noexcept = default;
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // resumes `h` on the loop. It is safe to call from any thread.
+    void post(std::coroutine_handle<> h) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(_mu);
+            _ready.push_back(h);
+        }
+        _cv.notify_one();
+    }
+
+    // an awaitable which resumes on the loop after `d`.
+    auto sleep_for(Clock::duration d) noexcept {
+        struct Awaiter {
+            EventLoop* loop;
+            Clock::time_point deadline;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> h) noexcept {
+                loop->_add_timer(deadline, h);
+            }
+
+            void await_resume() noexcept {}
+        };
+        return Awaiter {
+            .loop = this,
+            .deadline = Clock::now() + d,
+        };
+    }
+
+    // resumes everything ready, waiting for something to be ready up to
+    // `until` if nothing is.
+    // Returns the number of coroutines resumed.
+    size_t run_once(std::optional<Clock::time_point> until) noexcept {
+        std::deque<std::coroutine_handle<>> ready;
+        {
+            std::unique_lock<std::mutex> lock(_mu);
+            for(;;) {
+                _collect_due_timers();
+                if (!_ready.empty()) {
+                    break;
+                }
+                if (until && Clock::now() >= *until) {
+                    break;
+                }
+                auto wake = until;
+                if (!_timers.empty() && (!wake || _timers.top().deadline < *wake)) {
+                    wake = _timers.top().deadline;
+                }
+                if (wake) {
+                    _cv.wait_until(lock, *wake);
+                } else {
+                    _cv.wait(lock);
+                }
+            }
+            ready.swap(_ready);
+        }
+        for(auto h: ready) {
+            h.resume();
+        }
+        return ready.size();
+    }
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        std::coroutine_handle<> h;
+
+        bool operator>(const Timer& ano) const noexcept {
+            return deadline > ano.deadline;
+        }
+    };
+
+    void _add_timer(Clock::time_point deadline, std::coroutine_handle<> h) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(_mu);
+            _timers.push(Timer {
+                .deadline = deadline,
+                .h = h,
+            });
+        }
+        _cv.notify_one();
+    }
+
+    // with `_mu` held.
+    void _collect_due_timers() noexcept {
+        auto now = Clock::now();
+        while (!_timers.empty() && _timers.top().deadline <= now) {
+            _ready.push_back(_timers.top().h);
+            _timers.pop();
+        }
+    }
+
+private:
+    std::mutex _mu;
+    std::condition_variable _cv;
+    std::deque<std::coroutine_handle<>> _ready;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> _timers;
+};
+
+struct AsyncOptions {
+    // the maximal number of candidates under evaluation at once.
+    size_t in_flight = 8;
+    // A candidate which is not evaluated within this is rejected, and
+    // requested to stop. 0 means no timeout.
+    std::chrono::nanoseconds timeout {0};
+};
+
+template<class T>
+struct AsyncMinimized {
+    T value;
+    // `predicate_calls` counts every candidate started, including cancelled
+    // and timed-out ones.
+    MinimizeStats stats;
+    // candidates which are still in flight when an earlier one is accepted.
+    size_t cancelled = 0;
+    size_t timed_out = 0;
+};
+
+template<class Pred, class T>
+concept AsyncPredicate = std::same_as<std::invoke_result_t<Pred&, const T&>, Task<bool>>
+    || std::same_as<std::invoke_result_t<Pred&, const T&, std::stop_token>, Task<bool>>;
+
+namespace _impl_async {
+
+// A coroutine which starts eagerly and frees itself when it is done.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+
+template<class T>
+struct Slot {
+    T value;
+    std::stop_source stop;
+    EventLoop::Clock::time_point deadline;
+    bool done = false;
+    bool accepted = false;
+    bool timed_out = false;
+};
+
+template<class T, class Pred>
+Detached evaluate(std::shared_ptr<Slot<T>> slot, Pred& pred, size_t& outstanding) {
+    bool accepted = false;
+    if constexpr (std::invocable<Pred&, const T&, std::stop_token>) {
+        accepted = co_await pred(std::as_const(slot->value), slot->stop.get_token());
+    } else {
+        accepted = co_await pred(std::as_const(slot->value));
+    }
+    slot->accepted = accepted;
+    slot->done = true;
+    --outstanding;
+}
+
+}
+
+// Minimizes `init` like `minimize()`, but with an asynchronous predicate.
+// See above.
+template<Shrinkable T, AsyncPredicate<T> Pred>
+AsyncMinimized<T> minimize_async(
+    T init,
+    Pred pred,
+    EventLoop& loop,
+    const AsyncOptions& opts = {}) noexcept
+{
+    using namespace _impl_async;
+    using Clock = EventLoop::Clock;
+    FASSERT(opts.in_flight > 0);
+    AsyncMinimized<T> res {
+        .value = std::move(init),
+    };
+    size_t outstanding = 0;
+
+    for(bool accepted = true; accepted;) {
+        accepted = false;
+        auto candidates = shrink(res.value);
+        auto it = candidates.begin();
+        auto end = candidates.end();
+        std::deque<std::shared_ptr<Slot<T>>> window;
+        for(;;) {
+            while (window.size() < opts.in_flight && it != end) {
+                auto slot = std::make_shared<Slot<T>>(Slot<T> {
+                    .value = *it,
+                });
+                if (opts.timeout.count() > 0) {
+                    slot->deadline = Clock::now() + opts.timeout;
+                }
+                ++it;
+                ++res.stats.predicate_calls;
+                ++outstanding;
+                window.push_back(slot);
+                evaluate(std::move(slot), pred, outstanding);
+            }
+            if (window.empty()) {
+                break;
+            }
+            auto& head = window.front();
+            if (head->timed_out) {
+                window.pop_front();
+                continue;
+            }
+            if (head->done && head->accepted) {
+                ++res.stats.accepted;
+                res.value = std::move(head->value);
+                accepted = true;
+                for(size_t i = 1; i < window.size(); ++i) {
+                    if (!window[i]->done && !window[i]->timed_out) {
+                        window[i]->stop.request_stop();
+                        ++res.cancelled;
+                    }
+                }
+                break;
+            }
+            if (head->done) {
+                window.pop_front();
+                continue;
+            }
+            std::optional<Clock::time_point> until;
+            if (opts.timeout.count() > 0) {
+                for(auto const& slot: window) {
+                    if (!slot->done && !slot->timed_out && (!until || slot->deadline < *until)) {
+                        until = slot->deadline;
+                    }
+                }
+            }
+            loop.run_once(until);
+            auto now = Clock::now();
+            for(auto& slot: window) {
+                if (until && !slot->done && !slot->timed_out && slot->deadline <= now) {
+                    slot->timed_out = true;
+                    slot->stop.request_stop();
+                    ++res.timed_out;
+                }
+            }
+        }
+    }
+
+    // Cancelled and timed-out evaluations refer to `pred` and the loop, so
+    // they are drained before returning.
+    while (outstanding > 0) {
+        loop.run_once(std::nullopt);
+    }
+    return res;
+}
+
+}
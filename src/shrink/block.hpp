@@ -0,0 +1,169 @@
+#pragma once
+#include "core.hpp"
+#include "vec.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <concepts>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+// Minimization of vectors which shrinks many elements at a time.
+//
+// `ElemShrinker` shrinks one element per candidate, so a vector of, e.g.,
+// 100k counters which must all become 0 takes an accepted candidate per
+// counter. `minimize_blocks()` rather shrinks every element of a group to
+// its first candidate, e.g., 0 for integers, at the same time:
+// 1. by value: all elements equal to a value, for every distinct value in
+//    the order of first occurrences. It takes effect on totally ordered
+//    elements.
+// 2. by block: all elements of a block of consecutive ones, from the whole
+//    vector on. A rejected block is halved, and both halves are tried.
+// Both are repeated until neither is accepted, and then the result is
+// polished by `minimize()`, so no candidate of it fails, as with
+// `minimize()`.
+// Elements which have no candidates are kept as they are, and a group of
+// them costs no predicate call.
+
+namespace shrink {
+
+struct BlockOptions {
+    // whether to shrink elements by value before by block.
+    bool by_value = true;
+    // Blocks shorter than this are not tried; `minimize()` handles them.
+    size_t min_block = 2;
+};
+
+template<class T>
+struct BlockMinimized {
+    T value;
+    MinimizeStats stats;
+    // number of accepted candidates by value and by block.
+    size_t value_accepted = 0;
+    size_t block_accepted = 0;
+};
+
+namespace _impl_block {
+
+// the first, and usually smallest, candidate of `x`.
+template<Shrinkable T>
+std::optional<T> first_candidate(const T& x) noexcept {
+    auto candidates = shrink(x);
+    auto it = candidates.begin();
+    if (it == candidates.end()) {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+}
+
+template<Shrinkable T, class Pred>
+requires std::predicate<Pred&, const std::vector<T>&>
+BlockMinimized<std::vector<T>> minimize_blocks(
+    std::vector<T> init,
+    Pred pred,
+    const BlockOptions& opts = {}) noexcept
+{
+    using namespace _impl_block;
+    FASSERT(opts.min_block > 0);
+    BlockMinimized<std::vector<T>> res {
+        .value = std::move(init),
+    };
+    std::vector<T>& cur = res.value;
+
+    // tries the candidate in which elements of `cur` in `[first, last)`
+    // picked by `in_group` are shrunk.
+    auto try_group = [&](size_t first, size_t last, auto&& in_group) noexcept -> bool {
+        std::optional<std::vector<T>> cand;
+        for(size_t i = first; i < last; ++i) {
+            if (!in_group(i)) {
+                continue;
+            }
+            auto x = first_candidate(cur[i]);
+            if (!x) {
+                continue;
+            }
+            if (!cand) {
+                cand = cur;
+            }
+            (*cand)[i] = std::move(*x);
+        }
+        if (!cand) {
+            return false;
+        }
+        ++res.stats.predicate_calls;
+        if (!pred(std::as_const(*cand))) {
+            return false;
+        }
+        ++res.stats.accepted;
+        cur = std::move(*cand);
+        return true;
+    };
+
+    auto by_value = [&]() noexcept -> bool {
+        bool progress = false;
+        if constexpr (std::totally_ordered<T>) {
+            // indices of first occurrences of distinct values.
+            std::map<T, size_t> firsts;
+            for(size_t i = 0; i < cur.size(); ++i) {
+                firsts.try_emplace(cur[i], i);
+            }
+            std::vector<size_t> order;
+            for(auto const& [_, i]: firsts) {
+                order.push_back(i);
+            }
+            std::ranges::sort(order);
+            for(size_t first: order) {
+                // An acceptance only changes elements equal to another value,
+                // so `cur[first]` is still the value.
+                T v = cur[first];
+                if (try_group(first, cur.size(), [&](size_t i) { return cur[i] == v; })) {
+                    ++res.value_accepted;
+                    progress = true;
+                }
+            }
+        }
+        return progress;
+    };
+
+    auto by_block = [&]() noexcept -> bool {
+        bool progress = false;
+        auto bisect = [&](auto& self, size_t offset, size_t len) noexcept -> void {
+            if (len < opts.min_block) {
+                return;
+            }
+            if (try_group(offset, offset + len, [](size_t) { return true; })) {
+                ++res.block_accepted;
+                progress = true;
+                return;
+            }
+            size_t half = len / 2;
+            self(self, offset, half);
+            self(self, offset + half, len - half);
+        };
+        bisect(bisect, 0, cur.size());
+        return progress;
+    };
+
+    for(bool progress = true; progress;) {
+        progress = false;
+        if (opts.by_value && by_value()) {
+            progress = true;
+        }
+        if (by_block()) {
+            progress = true;
+        }
+    }
+
+    auto polished = minimize(std::move(cur), pred);
+    res.stats.predicate_calls += polished.stats.predicate_calls;
+    res.stats.accepted += polished.stats.accepted;
+    cur = std::move(polished.value);
+    return res;
+}
+
+}
@@ -1,7 +1,16 @@
 #pragma once
+#include "fassert.hpp"
+#include <array>
 #include <ranges>
 #include <type_traits>
+#include <optional>
+#include <random>
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 namespace shrink {
 
@@ -25,16 +34,142 @@ concept Shrinkable =
     };
 
 template<Shrinkable T>
-auto _shrink(T t) noexcept {
+constexpr auto _shrink(T t) noexcept {
     Shrinker<T> x(std::move(t));
     return std::move(x).shrink();
 }
 
 template<class T>
-auto shrink(T t) noexcept {
+constexpr auto shrink(T t) noexcept {
     return _shrink<std::remove_cvref_t<T>>(std::move(t));
 }
 
+namespace _impl_constexpr {
+
+inline void failed() noexcept {
+    FASSERT(false);
+}
+
+// `FASSERT` for shrinkers which work in constant evaluation as well, where
+// a failure is a compile error.
+constexpr void expect(bool cond) noexcept {
+    if (!cond) {
+        failed();
+    }
+}
+
+}
+
+// the number of candidates of `v`.
+template<Shrinkable T>
+constexpr size_t candidate_count(const T& v) noexcept {
+    auto xs = shrink(v);
+    size_t res = 0;
+    for(auto it = xs.begin(), end = xs.end(); it != end; ++it) {
+        ++res;
+    }
+    return res;
+}
+
+// all candidates of the constant `V`, in order, materialized at compile time,
+// so a hot loop can walk an array rather than step shrinker iterators, e.g.,
+//
+//     static constexpr auto kCandidates = shrink::candidate_table<1000>();
+//
+// It works for types whose shrinkers are `constexpr`, e.g., integers and
+// `Unshrink`.
+template<auto V>
+requires Shrinkable<std::remove_cv_t<decltype(V)>>
+consteval auto candidate_table() noexcept {
+    using T = std::remove_cv_t<decltype(V)>;
+    std::array<T, candidate_count(V)> res {};
+    size_t i = 0;
+    for(auto&& x: shrink(V)) {
+        res[i] = x;
+        ++i;
+    }
+    return res;
+}
+
+// `Serializer<T>` is specialized next to `Shrinker<T>` for every type which
+// can be persisted, e.g., into a checkpoint.
+// `write()` appends the encoding of a value to `out`.
+// `read()` consumes an encoded value from the front of `in`, or returns
+// `std::nullopt` if `in` is truncated or malformed.
+// Encodings use the native byte order.
+template<class T>
+struct Serializer;
+
+template<class T>
+concept Serializable = requires(
+    const T& v,
+    std::vector<std::byte>& out,
+    std::span<const std::byte>& in)
+{
+    { Serializer<T>::write(out, v) } noexcept;
+    { Serializer<T>::read(in) } noexcept -> std::same_as<std::optional<T>>;
+};
+
+// the random source of generators.
+using Random = std::mt19937_64;
+
+// `Generator<T>` is specialized next to `Shrinker<T>` for every type whose
+// values can be generated randomly.
+// `generate()` returns a random value whose magnitude, e.g., the length of
+// a vector, grows with `size`.
+template<class T>
+struct Generator;
+
+template<class T>
+concept Generatable = requires(Random& rng, size_t size) {
+    { Generator<T>::generate(rng, size) } noexcept -> std::same_as<T>;
+};
+
+namespace _impl_serde {
+
+template<class T>
+requires std::is_trivially_copyable_v<T>
+void write_raw(std::vector<std::byte>& out, const T& v) noexcept {
+    auto const* p = reinterpret_cast<const std::byte*>(&v);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template<class T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+std::optional<T> read_raw(std::span<const std::byte>& in) noexcept {
+    if (in.size() < sizeof(T)) {
+        return std::nullopt;
+    }
+    T v;
+    std::memcpy(&v, in.data(), sizeof(T));
+    in = in.subspan(sizeof(T));
+    return v;
+}
+
+// LEB128, 7 bits a byte from the least significant ones, for integers
+// which are mostly small.
+inline void write_varint(std::vector<std::byte>& out, uint64_t v) noexcept {
+    for(; v >= 0x80; v >>= 7) {
+        out.push_back(static_cast<std::byte>((v & 0x7f) | 0x80));
+    }
+    out.push_back(static_cast<std::byte>(v));
+}
+
+inline std::optional<uint64_t> read_varint(std::span<const std::byte>& in) noexcept {
+    uint64_t v = 0;
+    for(size_t i = 0; i < in.size() && i < 10; ++i) {
+        auto x = std::to_integer<uint64_t>(in[i]);
+        v |= (x & 0x7f) << (7 * i);
+        if ((x & 0x80) == 0) {
+            in = in.subspan(i + 1);
+            return v;
+        }
+    }
+    return std::nullopt;
+}
+
+}
+
 template<class T>
 struct Unshrink {
     T v;
@@ -47,19 +182,19 @@ struct _EmptyShrinkerImpl {
     using iterator = value_type const*;
     using const_iterator = iterator;
 
-    iterator begin() const noexcept {
+    constexpr iterator begin() const noexcept {
         return nullptr;
     }
 
-    iterator end() const noexcept {
+    constexpr iterator end() const noexcept {
         return nullptr;
     }
 
-    iterator cbegin() const noexcept {
+    constexpr iterator cbegin() const noexcept {
         return begin();
     }
 
-    iterator cend() const noexcept {
+    constexpr iterator cend() const noexcept {
         return end();
     }
 };
@@ -68,17 +203,43 @@ struct _EmptyShrinkerImpl {
 template<class T>
 requires std::is_move_constructible_v<T>
 struct Shrinker<Unshrink<T>> {
-    explicit Shrinker(Unshrink<T> v) noexcept
+    constexpr explicit Shrinker(Unshrink<T> v) noexcept
     {}
 
-    _EmptyShrinkerImpl<Unshrink<T>> shrink() && noexcept {
+    constexpr _EmptyShrinkerImpl<Unshrink<T>> shrink() && noexcept {
         return _EmptyShrinkerImpl<Unshrink<T>>();
     }
 };
 
+template<Serializable T>
+struct Serializer<Unshrink<T>> {
+    static void write(std::vector<std::byte>& out, const Unshrink<T>& x) noexcept {
+        Serializer<T>::write(out, x.v);
+    }
+
+    static std::optional<Unshrink<T>> read(std::span<const std::byte>& in) noexcept {
+        auto v = Serializer<T>::read(in);
+        if (!v) {
+            return std::nullopt;
+        }
+        return Unshrink<T> {
+            .v = std::move(*v),
+        };
+    }
+};
+
+template<Generatable T>
+struct Generator<Unshrink<T>> {
+    static Unshrink<T> generate(Random& rng, size_t size) noexcept {
+        return Unshrink<T> {
+            .v = Generator<T>::generate(rng, size),
+        };
+    }
+};
+
 template<class T>
 requires std::is_move_constructible_v<T>
-auto unshrink(T v) noexcept {
+constexpr auto unshrink(T v) noexcept {
     return Unshrink<T> {
         .v = std::move(v),
     };
@@ -0,0 +1,364 @@
+#pragma once
+#include "core.hpp"
+#include "fassert.hpp"
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+// Shrinkers written as coroutines which `co_yield` candidates, e.g.,
+//
+//     template<>
+//     struct shrink::Shrinker<Point> {
+//         explicit Shrinker(Point p) noexcept
+//         :   _p(p)
+//         {}
+//
+//         auto shrink() && noexcept {
+//             return shrink::coroutine_shrinker([p = _p]() -> shrink::Yield<Point> {
+//                 for(int x: shrink::shrink(p.x)) {
+//                     co_yield Point {.x = x, .y = p.y};
+//                 }
+//                 ...
+//             });
+//         }
+//
+//     private:
+//         Point _p;
+//     };
+//
+// The callable is kept in the returned range, so are captures of a lambda,
+// and every `begin()` calls it for a fresh coroutine.
+// Iterators are forward iterators: a copied iterator shares the coroutine
+// until either of them steps, which then replays a fresh coroutine up to
+// its position. So stepping a single iterator, as `minimize()` does, never
+// replays.
+//
+// Coroutine frames are recycled through a per-thread pool, so a shrink
+// round allocates nothing once the pool is warm.
+// Like `ChainShrinker`, iterators must not outlive the range, nor survive
+// moving it.
+
+namespace shrink {
+
+namespace _impl_coro {
+
+// free lists of frames, in classes of `kGranule` bytes.
+class FramePool {
+public:
+    static constexpr size_t kGranule = 64;
+    static constexpr size_t kClasses = 16;
+
+    static void* allocate(size_t n) {
+        size_t c = _class_of(n);
+        if (c >= kClasses) {
+            return ::operator new(n);
+        }
+        auto& head = _heads()[c];
+        if (head != nullptr) {
+            auto* res = head;
+            head = head->next;
+            return res;
+        }
+        return ::operator new((c + 1) * kGranule);
+    }
+
+    static void deallocate(void* p, size_t n) noexcept {
+        size_t c = _class_of(n);
+        if (c >= kClasses) {
+            ::operator delete(p);
+            return;
+        }
+        auto& head = _heads()[c];
+        head = new(p) Node {.next = head};
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    static size_t _class_of(size_t n) noexcept {
+        return (n + kGranule - 1) / kGranule - 1;
+    }
+
+    // Frames stay in the pool until the thread exits.
+    struct Heads {
+        std::array<Node*, kClasses> heads {};
+
+        ~Heads() {
+            for(auto* head: heads) {
+                while (head != nullptr) {
+                    auto* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    static std::array<Node*, kClasses>& _heads() noexcept {
+        thread_local Heads heads;
+        return heads.heads;
+    }
+};
+
+}
+
+template<class T>
+class Yield {
+public:
+    struct promise_type {
+        std::optional<T> current;
+        // number of iterators sharing the coroutine.
+        size_t refs = 0;
+
+        Yield get_return_object() noexcept {
+            return Yield(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        template<class U>
+        requires std::convertible_to<U, T>
+        std::suspend_always yield_value(U&& v) noexcept {
+            current.emplace(std::forward<U>(v));
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+
+        static void* operator new(size_t n) {
+            return _impl_coro::FramePool::allocate(n);
+        }
+
+        static void operator delete(void* p, size_t n) noexcept {
+            _impl_coro::FramePool::deallocate(p, n);
+        }
+    };
+
+    Yield(const Yield&) = delete;
+    Yield& operator=(const Yield&) = delete;
+
+    Yield(Yield&& ano) noexcept
+    :   _h(std::exchange(ano._h, {}))
+    {}
+
+    ~Yield() {
+        if (_h) {
+            _h.destroy();
+        }
+    }
+
+    // hands the coroutine over to the caller.
+    std::coroutine_handle<promise_type> release() && noexcept {
+        return std::exchange(_h, {});
+    }
+
+private:
+    explicit Yield(std::coroutine_handle<promise_type> h) noexcept
+    :   _h(h)
+    {}
+
+private:
+    std::coroutine_handle<promise_type> _h;
+};
+
+namespace _impl_coro {
+
+template<class T, class F>
+struct CoroShrinker {
+    using Handle = std::coroutine_handle<typename Yield<T>::promise_type>;
+
+    struct Iter {
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(const CoroShrinker* owner) noexcept
+        :   _owner(owner),
+            _h(owner->_start()),
+            _pos(0)
+        {
+            _h.resume();
+            _settle();
+        }
+
+        Iter(const Iter& ano) noexcept
+        :   _owner(ano._owner),
+            _h(ano._h),
+            _pos(ano._pos)
+        {
+            _retain();
+        }
+
+        Iter& operator=(const Iter& ano) noexcept {
+            if (this != &ano) {
+                Iter copied(ano);
+                swap(copied);
+            }
+            return *this;
+        }
+
+        Iter(Iter&& ano) noexcept
+        :   _owner(ano._owner),
+            _h(std::exchange(ano._h, {})),
+            _pos(ano._pos)
+        {}
+
+        Iter& operator=(Iter&& ano) noexcept {
+            if (this != &ano) {
+                Iter moved(std::move(ano));
+                swap(moved);
+            }
+            return *this;
+        }
+
+        ~Iter() {
+            _release();
+        }
+
+        void swap(Iter& ano) noexcept {
+            std::swap(_owner, ano._owner);
+            std::swap(_h, ano._h);
+            std::swap(_pos, ano._pos);
+        }
+
+        T operator*() const noexcept {
+            FASSERT(_h);
+            return *_h.promise().current;
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_h);
+            if (_h.promise().refs > 1) {
+                _replay();
+            }
+            _h.resume();
+            ++_pos;
+            _settle();
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            if (!_h || !ano._h) {
+                return !_h && !ano._h;
+            }
+            return _owner == ano._owner && _pos == ano._pos;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        // becomes the end when the coroutine is done.
+        void _settle() noexcept {
+            if (_h.done()) {
+                _release();
+            }
+        }
+
+        // steps a fresh coroutine of its own to the current position.
+        void _replay() noexcept {
+            _release();
+            _h = _owner->_start();
+            _h.resume();
+            for(size_t i = 0; i < _pos; ++i) {
+                FASSERT(!_h.done());
+                _h.resume();
+            }
+        }
+
+        void _retain() noexcept {
+            if (_h) {
+                ++_h.promise().refs;
+            }
+        }
+
+        void _release() noexcept {
+            if (_h) {
+                if (--_h.promise().refs == 0) {
+                    _h.destroy();
+                }
+                _h = {};
+            }
+        }
+
+    private:
+        const CoroShrinker* _owner = nullptr;
+        Handle _h;
+        size_t _pos = 0;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(this);
+    }
+
+    Iter end() const noexcept {
+        return Iter();
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+    explicit CoroShrinker(F f) noexcept
+    :   _f(std::move(f))
+    {}
+
+private:
+    Handle _start() const noexcept {
+        Handle h = std::invoke(_f).release();
+        h.promise().refs = 1;
+        return h;
+    }
+
+private:
+    F _f;
+};
+
+}
+
+// a shrinker range over candidates which `f()` yields. See above.
+template<class F>
+requires std::invocable<const F&>
+auto coroutine_shrinker(F f) noexcept {
+    using R = std::invoke_result_t<const F&>;
+    using T = typename std::remove_cvref_t<decltype(
+        *std::declval<typename R::promise_type&>().current)>;
+    return _impl_coro::CoroShrinker<T, F>(std::move(f));
+}
+
+}
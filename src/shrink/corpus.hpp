@@ -0,0 +1,314 @@
+#pragma once
+#include "core.hpp"
+#include "fassert.hpp"
+#include <concepts>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A corpus is a binary file of minimized values of one type.
+//
+// layout:
+//   header: magic "SHRKCORP", u32 version, u32 byte-order mark
+//   entries: u64 payload length, u64 reserved, payload, zero padding
+//
+// Headers and entries are 16-byte aligned, and so are payloads, so payloads
+// of raw-encoded types can be used in place in the mapped file.
+
+namespace shrink {
+
+namespace _impl_corpus {
+
+constexpr std::string_view kMagic = "SHRKCORP";
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kAlign = 16;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kEntryHeaderSize = 16;
+
+constexpr size_t padding(size_t n) noexcept {
+    return (kAlign - n % kAlign) % kAlign;
+}
+
+// Whether `Serializer<T>` encodes a value as exactly its bytes in memory.
+template<class T>
+constexpr bool is_raw_encoded = (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+    || std::is_same_v<T, std::byte>;
+
+template<class T>
+constexpr bool is_raw_encoded<Unshrink<T>> = is_raw_encoded<T>
+    && sizeof(Unshrink<T>) == sizeof(T);
+
+}
+
+// A value in a corpus, viewed in place if possible:
+// * `const T&` into the mapped file, if `T` is raw-encoded;
+// * `std::span<const U>` into the mapped file, if `T` is `std::vector<U>` of
+//   a raw-encoded `U`;
+// * otherwise, a deserialized `T`.
+template<class T>
+struct CorpusView {
+    using type = T;
+};
+
+template<class T>
+requires _impl_corpus::is_raw_encoded<T>
+struct CorpusView<T> {
+    using type = const T&;
+};
+
+template<class U>
+requires _impl_corpus::is_raw_encoded<U> && (alignof(U) <= sizeof(uint64_t))
+struct CorpusView<std::vector<U>> {
+    using type = std::span<const U>;
+};
+
+template<class T>
+using CorpusView_t = typename CorpusView<T>::type;
+
+// Appends values to a corpus file, creating it if it does not exist.
+class CorpusWriter {
+public:
+    static std::optional<CorpusWriter> open(const std::filesystem::path& path) noexcept {
+        std::error_code ec;
+        bool fresh = !std::filesystem::exists(path, ec)
+            || std::filesystem::file_size(path, ec) == 0;
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        if (!out) {
+            return std::nullopt;
+        }
+        CorpusWriter res(std::move(out));
+        if (fresh) {
+            std::vector<std::byte> buf;
+            auto const* magic = reinterpret_cast<const std::byte*>(_impl_corpus::kMagic.data());
+            buf.insert(buf.end(), magic, magic + _impl_corpus::kMagic.size());
+            _impl_serde::write_raw(buf, _impl_corpus::kVersion);
+            _impl_serde::write_raw(buf, _impl_corpus::kByteOrderMark);
+            if (!res._write(buf)) {
+                return std::nullopt;
+            }
+        }
+        return res;
+    }
+
+    CorpusWriter(CorpusWriter&&) noexcept = default;
+    CorpusWriter& operator=(CorpusWriter&&) noexcept = default;
+
+    template<Serializable T>
+    bool append(const T& v) noexcept {
+        std::vector<std::byte> buf(_impl_corpus::kEntryHeaderSize);
+        Serializer<T>::write(buf, v);
+        uint64_t len = buf.size() - _impl_corpus::kEntryHeaderSize;
+        std::memcpy(buf.data(), &len, sizeof(len));
+        buf.resize(buf.size() + _impl_corpus::padding(buf.size()));
+        return _write(buf);
+    }
+
+private:
+    explicit CorpusWriter(std::ofstream out) noexcept
+    :   _out(std::move(out))
+    {}
+
+    bool _write(std::span<const std::byte> xs) noexcept {
+        _out.write(reinterpret_cast<const char*>(xs.data()), xs.size());
+        _out.flush();
+        return static_cast<bool>(_out);
+    }
+
+private:
+    std::ofstream _out;
+};
+
+// A read-only, memory-mapped corpus file.
+class Corpus {
+public:
+    static std::optional<Corpus> open(const std::filesystem::path& path) noexcept {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(_impl_corpus::kHeaderSize)) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        size_t size = st.st_size;
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return std::nullopt;
+        }
+        Corpus res(std::span<const std::byte>(static_cast<const std::byte*>(addr), size));
+        if (!res._index()) {
+            return std::nullopt;
+        }
+        return res;
+    }
+
+    Corpus(const Corpus&) = delete;
+    Corpus& operator=(const Corpus&) = delete;
+
+    Corpus(Corpus&& ano) noexcept
+    :   _mapped(std::exchange(ano._mapped, {})),
+        _entries(std::move(ano._entries))
+    {}
+
+    Corpus& operator=(Corpus&& ano) noexcept {
+        if (this != &ano) {
+            _unmap();
+            _mapped = std::exchange(ano._mapped, {});
+            _entries = std::move(ano._entries);
+        }
+        return *this;
+    }
+
+    ~Corpus() {
+        _unmap();
+    }
+
+    size_t size() const noexcept {
+        return _entries.size();
+    }
+
+    // the raw payload of the `i`-th entry.
+    std::span<const std::byte> payload(size_t i) const noexcept {
+        FASSERT(i < _entries.size());
+        return _entries[i];
+    }
+
+    // deserializes the `i`-th entry.
+    template<Serializable T>
+    std::optional<T> load(size_t i) const noexcept {
+        auto in = payload(i);
+        auto res = Serializer<T>::read(in);
+        if (!in.empty()) {
+            return std::nullopt;
+        }
+        return res;
+    }
+
+    // views the `i`-th entry without copying, if `T` allows.
+    // See `CorpusView`.
+    template<Serializable T>
+    std::optional<std::remove_cvref_t<CorpusView_t<T>>> view(size_t i) const noexcept
+    requires (!std::is_reference_v<CorpusView_t<T>>)
+    {
+        if constexpr (std::is_same_v<CorpusView_t<T>, T>) {
+            return load<T>(i);
+        } else {
+            using U = typename T::value_type;
+            auto in = payload(i);
+            auto n = _impl_serde::read_raw<uint64_t>(in);
+            if (!n || in.size() != *n * sizeof(U)) {
+                return std::nullopt;
+            }
+            return std::span<const U>(reinterpret_cast<const U*>(in.data()), *n);
+        }
+    }
+
+    template<Serializable T>
+    const T* view(size_t i) const noexcept
+    requires std::is_reference_v<CorpusView_t<T>>
+    {
+        auto in = payload(i);
+        if (in.size() != sizeof(T)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(in.data());
+    }
+
+private:
+    explicit Corpus(std::span<const std::byte> mapped) noexcept
+    :   _mapped(mapped)
+    {}
+
+    bool _index() noexcept {
+        auto in = _mapped;
+        auto magic = _impl_corpus::kMagic;
+        if (std::memcmp(in.data(), magic.data(), magic.size()) != 0) {
+            return false;
+        }
+        in = in.subspan(magic.size());
+        auto version = _impl_serde::read_raw<uint32_t>(in);
+        auto bom = _impl_serde::read_raw<uint32_t>(in);
+        if (*version != _impl_corpus::kVersion || *bom != _impl_corpus::kByteOrderMark) {
+            return false;
+        }
+        while (!in.empty()) {
+            auto len = _impl_serde::read_raw<uint64_t>(in);
+            auto reserved = _impl_serde::read_raw<uint64_t>(in);
+            if (!len || !reserved) {
+                return false;
+            }
+            size_t padded = *len + _impl_corpus::padding(*len);
+            if (in.size() < padded) {
+                return false;
+            }
+            _entries.push_back(in.subspan(0, *len));
+            in = in.subspan(padded);
+        }
+        return true;
+    }
+
+    void _unmap() noexcept {
+        if (!_mapped.empty()) {
+            ::munmap(const_cast<std::byte*>(_mapped.data()), _mapped.size());
+            _mapped = {};
+        }
+    }
+
+private:
+    std::span<const std::byte> _mapped;
+    std::vector<std::span<const std::byte>> _entries;
+};
+
+template<class T>
+struct CorpusFailure {
+    size_t index;
+    T value;
+};
+
+// Replays every entry of `corpus` against `prop`, which returns true iff the
+// property holds.
+// `prop` receives entries in place (see `CorpusView`) if it accepts them;
+// otherwise, it receives deserialized values.
+// Returns the first entry which falsifies `prop`.
+template<Serializable T, class Prop>
+std::optional<CorpusFailure<T>> replay_corpus(const Corpus& corpus, Prop&& prop) noexcept {
+    constexpr bool kInPlace = !std::is_same_v<CorpusView_t<T>, T>
+        && std::predicate<Prop&, CorpusView_t<T>>;
+    for(size_t i = 0, n = corpus.size(); i < n; ++i) {
+        bool holds = true;
+        if constexpr (kInPlace) {
+            auto v = corpus.view<T>(i);
+            FASSERT(v);
+            holds = prop(*v);
+        } else {
+            auto v = corpus.load<T>(i);
+            FASSERT(v);
+            holds = prop(std::as_const(*v));
+        }
+        if (!holds) {
+            auto v = corpus.load<T>(i);
+            return CorpusFailure<T> {
+                .index = i,
+                .value = std::move(*v),
+            };
+        }
+    }
+    return std::nullopt;
+}
+
+}
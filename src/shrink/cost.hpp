@@ -0,0 +1,119 @@
+#pragma once
+#include "core.hpp"
+#include "minimize.hpp"
+#include "trace.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+// Minimization which minimizes the runtime of the predicate along with the
+// size, so the reproducer is cheap to replay, e.g., in CI.
+//
+// A smaller value may take a slow path: a vector of 3 elements which fails
+// in 30 s is a worse reproducer than one of 4 which fails in 50 ms.
+// `minimize_cost()` times every predicate call, and in every round
+// * drops failing candidates slower than a budget, i.e., the fastest
+//   runtime of the values accepted so far times `max_slowdown`, or
+//   `min_budget` if it is larger, since short runtimes are mostly noise;
+// * compares up to `lookahead` failing candidates within the budget by the
+//   objective `seconds + size_weight * size`, where the size of a range is
+//   its number of elements, and 1 otherwise;
+// * and accepts the one of the least objective.
+// The minimization stops when no candidate fails within the budget, so the
+// result is as small as `minimize()` makes it only if the predicate never
+// slows down.
+// Runtimes of the initial value, which is run first, and of every accepted
+// candidate are reported in order.
+
+namespace shrink {
+
+struct CostOptions {
+    // the number of failing candidates within the budget compared in a
+    // round. 1 accepts the first one, as `minimize()` does.
+    size_t lookahead = 4;
+    // weight of an element against a second of runtime.
+    double size_weight = 0;
+    double max_slowdown = 1.25;
+    std::chrono::nanoseconds min_budget = std::chrono::milliseconds(1);
+};
+
+template<class T>
+struct CostMinimized {
+    T value;
+    MinimizeStats stats;
+    // predicate runtimes of the initial value and of every accepted
+    // candidate, in order.
+    std::vector<std::chrono::nanoseconds> runtimes;
+    // total runtime of all predicate calls.
+    std::chrono::nanoseconds total_runtime {0};
+};
+
+// Minimizes `init` for both size and predicate runtime. See above.
+// `Clock` times predicate calls, e.g., a fake clock in tests.
+template<class Clock = std::chrono::steady_clock, Shrinkable T, class Pred>
+requires std::predicate<Pred&, const T&>
+CostMinimized<T> minimize_cost(
+    T init,
+    Pred pred,
+    const CostOptions& opts = {}) noexcept
+{
+    FASSERT(opts.lookahead > 0);
+    CostMinimized<T> res {
+        .value = std::move(init),
+    };
+    auto run = [&](const T& v) noexcept -> std::pair<bool, std::chrono::nanoseconds> {
+        auto start = Clock::now();
+        bool holds = pred(v);
+        auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        ++res.stats.predicate_calls;
+        res.total_runtime += dur;
+        return {holds, dur};
+    };
+
+    auto [_, init_runtime] = run(std::as_const(res.value));
+    res.runtimes.push_back(init_runtime);
+    auto fastest = init_runtime;
+
+    for(;;) {
+        auto budget = std::max(
+            opts.min_budget,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(fastest * opts.max_slowdown));
+        std::optional<T> chosen;
+        std::chrono::nanoseconds chosen_runtime {0};
+        double chosen_objective = 0;
+        size_t seen = 0;
+        auto candidates = shrink(res.value);
+        for(auto it = candidates.begin(), end = candidates.end(); it != end; ++it) {
+            T cand = *it;
+            auto [holds, runtime] = run(std::as_const(cand));
+            if (!holds || runtime > budget) {
+                continue;
+            }
+            double objective = std::chrono::duration<double>(runtime).count()
+                + opts.size_weight * _impl_trace::size_of(cand);
+            if (!chosen || objective < chosen_objective) {
+                chosen = std::move(cand);
+                chosen_runtime = runtime;
+                chosen_objective = objective;
+            }
+            if (++seen >= opts.lookahead) {
+                break;
+            }
+        }
+        if (!chosen) {
+            break;
+        }
+        ++res.stats.accepted;
+        res.value = std::move(*chosen);
+        res.runtimes.push_back(chosen_runtime);
+        fastest = std::min(fastest, chosen_runtime);
+    }
+    return res;
+}
+
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include "core.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Coverage-guided minimization, for predicates which are slow, e.g.,
+// differential checks of wrong results rather than crashes.
+//
+// The predicate is split in two:
+// * a probe, which runs the code under test on a candidate, e.g., the
+//   program whose output is compared, and which is instrumented by
+//   `-fsanitize-coverage=inline-8bit-counters`;
+// * and the full predicate, e.g., the probe and the slow oracle.
+// For every candidate, `minimize_coverage()` resets the edge counters, runs
+// the probe, and takes a fingerprint of the counters. Then
+// * with `keep_target`, a candidate whose fingerprint differs from that of
+//   the initial value, i.e., which takes another path, is rejected, as
+//   afl-tmin does. With `trust_target` as well, a candidate which keeps it
+//   is accepted without the predicate;
+// * a candidate whose fingerprint is that of a rejected candidate is
+//   skipped as rejected, since it most likely behaves the same;
+// * otherwise the predicate decides.
+// Skipping is a heuristic: a failure which coverage does not tell may be
+// missed. But every accepted candidate fails, unless `trust_target` is on.
+//
+// Counters are read from regions registered by
+// `register_coverage_counters()`. The SanitizerCoverage runtime registers
+// the regions of every instrumented module if exactly one translation unit
+// of the program expands `SHRINK_COVERAGE_COUNTERS()` at namespace scope.
+// Only the code under test should be instrumented, since any other
+// instrumented code, e.g., this library, adds noise to fingerprints.
+// Counters are global, so predicates must run on one thread at a time.
+
+namespace shrink {
+
+struct CoverageOptions {
+    // Whether accepted candidates must keep the fingerprint of the initial
+    // value.
+    bool keep_target = false;
+    // Whether candidates which keep the fingerprint of the initial value are
+    // accepted without calling the predicate. It requires `keep_target`.
+    bool trust_target = false;
+    // Whether hit counts, in buckets of 1, 2, 3, 4-7, 8-15, 16-31, 32-127
+    // and 128+, make fingerprints, or only whether edges are hit.
+    bool hit_counts = true;
+};
+
+template<class T>
+struct CoverageMinimized {
+    T value;
+    MinimizeStats stats;
+    // number of candidates rejected by their fingerprints without calling
+    // the predicate, because they leave the target path ...
+    size_t off_target = 0;
+    // ... or because their fingerprints are of rejected ones.
+    size_t memo_hits = 0;
+    // number of distinct fingerprints of rejected candidates.
+    size_t rejected_fingerprints = 0;
+};
+
+// regions of 8-bit edge counters.
+inline std::vector<std::span<uint8_t>>& coverage_regions() noexcept {
+    static std::vector<std::span<uint8_t>> regions;
+    return regions;
+}
+
+// registers `[start, stop)` unless it is already registered.
+inline void register_coverage_counters(uint8_t* start, uint8_t* stop) noexcept {
+    auto& regions = coverage_regions();
+    bool known = std::ranges::any_of(regions, [&](std::span<uint8_t> r) {
+        return r.data() == start;
+    });
+    if (!known && start < stop) {
+        regions.emplace_back(start, stop);
+    }
+}
+
+inline void reset_coverage() noexcept {
+    for(std::span<uint8_t> r: coverage_regions()) {
+        std::memset(r.data(), 0, r.size());
+    }
+}
+
+namespace _impl_coverage {
+
+inline uint8_t bucket(uint8_t count) noexcept {
+    if (count <= 3) {
+        return count;
+    }
+    if (count < 8) {
+        return 4;
+    }
+    if (count < 16) {
+        return 5;
+    }
+    if (count < 32) {
+        return 6;
+    }
+    if (count < 128) {
+        return 7;
+    }
+    return 8;
+}
+
+}
+
+// the fingerprint of edges hit since the last `reset_coverage()`.
+inline uint64_t coverage_fingerprint(bool hit_counts = true) noexcept {
+    // FNV-1a over indices of hit edges and their buckets.
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&](uint64_t x) noexcept {
+        for(size_t i = 0; i < sizeof(x); ++i) {
+            h ^= (x >> (i * 8)) & 0xff;
+            h *= 0x100000001b3ULL;
+        }
+    };
+    uint64_t index = 0;
+    for(std::span<uint8_t> r: coverage_regions()) {
+        for(uint8_t count: r) {
+            if (count != 0) {
+                mix(index);
+                mix(hit_counts ? _impl_coverage::bucket(count) : 1);
+            }
+            ++index;
+        }
+    }
+    return h;
+}
+
+// Minimizes `init` guided by coverage of `probe`. See above.
+template<Shrinkable T, class Probe, class Pred>
+requires std::invocable<Probe&, const T&>
+    && std::predicate<Pred&, const T&>
+CoverageMinimized<T> minimize_coverage(
+    T init,
+    Probe probe,
+    Pred pred,
+    const CoverageOptions& opts = {}) noexcept
+{
+    FASSERT(!opts.trust_target || opts.keep_target);
+    CoverageMinimized<T> res {
+        .value = std::move(init),
+    };
+    auto fingerprint = [&](const T& v) noexcept -> uint64_t {
+        reset_coverage();
+        std::invoke(probe, v);
+        return coverage_fingerprint(opts.hit_counts);
+    };
+
+    uint64_t target = fingerprint(std::as_const(res.value));
+    std::unordered_set<uint64_t> rejected;
+    for(bool accepted = true; accepted;) {
+        accepted = false;
+        auto candidates = shrink(res.value);
+        for(auto it = candidates.begin(), end = candidates.end(); it != end; ++it) {
+            T cand = *it;
+            uint64_t f = fingerprint(std::as_const(cand));
+            if (opts.keep_target && f != target) {
+                ++res.off_target;
+                continue;
+            }
+            if (rejected.contains(f)) {
+                ++res.memo_hits;
+                continue;
+            }
+            bool holds = opts.trust_target;
+            if (!holds) {
+                ++res.stats.predicate_calls;
+                holds = pred(std::as_const(cand));
+            }
+            if (!holds) {
+                rejected.insert(f);
+                continue;
+            }
+            ++res.stats.accepted;
+            res.value = std::move(cand);
+            accepted = true;
+            break;
+        }
+    }
+    res.rejected_fingerprints = rejected.size();
+    return res;
+}
+
+}
+
+#define SHRINK_COVERAGE_COUNTERS() \
+    extern "C" void __sanitizer_cov_8bit_counters_init(uint8_t* start, uint8_t* stop) { \
+        ::shrink::register_coverage_counters(start, stop); \
+    }
@@ -0,0 +1,472 @@
+#pragma once
+#include "core.hpp"
+#include "vec.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <concepts>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Out-of-core shrinking of inputs larger than memory, e.g., captured traces
+// of tens of GB.
+//
+// `Extents<T>` is a file of `T`s, mapped read-only, and a list of extents
+// over it, i.e., ranges of elements, in order. Candidates are lists of
+// extents over the same mapping, so neither the input nor a candidate is
+// ever copied, and a candidate costs memory only for its extents, whose
+// number grows by at most one per accepted candidate.
+// Predicates stream a candidate by `for_each_chunk()`, in chunks of at most
+// `ExtentsOptions::memory_budget` bytes. Pages of a chunk are dropped after
+// it is visited, so resident memory of the mapping stays within about the
+// budget, plus readahead of the kernel, whatever the size of the file.
+//
+// Like spans, `Extents<T>` shrinks by removing consecutive elements, in the
+// order of `LenShrinker`, but not elements, which are in the file.
+// Its shrinkers accept a hint, so `MinimizeOptions::resume` takes effect.
+
+namespace shrink {
+
+struct ExtentsOptions {
+    // the maximal size of a chunk passed to predicates, and thus about the
+    // peak resident memory of the mapping.
+    size_t memory_budget = size_t(64) << 20;
+};
+
+// consecutive elements of a file, in elements.
+struct Extent {
+    uint64_t offset = 0;
+    uint64_t len = 0;
+
+    bool operator==(const Extent&) const noexcept = default;
+};
+
+namespace _impl_extents {
+
+// A read-only, memory-mapped file, shared by all candidates of it.
+class Mapping {
+public:
+    static std::shared_ptr<const Mapping> open(
+        const std::filesystem::path& path,
+        const ExtentsOptions& opts) noexcept
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        size_t size = st.st_size;
+        void* addr = nullptr;
+        if (size > 0) {
+            addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return nullptr;
+        }
+        if (addr != nullptr) {
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+        }
+        return std::shared_ptr<const Mapping>(new Mapping(
+            std::span<const std::byte>(static_cast<const std::byte*>(addr), size),
+            opts));
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping() {
+        if (!_mapped.empty()) {
+            ::munmap(const_cast<std::byte*>(_mapped.data()), _mapped.size());
+        }
+    }
+
+    std::span<const std::byte> bytes() const noexcept {
+        return _mapped;
+    }
+
+    const ExtentsOptions& options() const noexcept {
+        return _opts;
+    }
+
+    // drops resident pages of `xs`, which are read again from the file on
+    // the next access.
+    void release(std::span<const std::byte> xs) const noexcept {
+        if (xs.empty()) {
+            return;
+        }
+        static const uintptr_t page = ::sysconf(_SC_PAGESIZE);
+        auto base = reinterpret_cast<uintptr_t>(_mapped.data());
+        auto first = reinterpret_cast<uintptr_t>(xs.data());
+        auto last = first + xs.size();
+        first = base + (first - base) / page * page;
+        ::madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+    }
+
+private:
+    Mapping(std::span<const std::byte> mapped, const ExtentsOptions& opts) noexcept
+    :   _mapped(mapped),
+        _opts(opts)
+    {}
+
+private:
+    std::span<const std::byte> _mapped;
+    ExtentsOptions _opts;
+};
+
+// `xs` without the elements of `hole`, where adjacent extents are merged.
+inline std::vector<Extent> remove(
+    std::span<const Extent> xs,
+    const _impl_vec::Hole& hole) noexcept
+{
+    std::vector<Extent> res;
+    res.reserve(xs.size() + 1);
+    auto push = [&](uint64_t offset, uint64_t len) noexcept {
+        if (len == 0) {
+            return;
+        }
+        if (!res.empty() && res.back().offset + res.back().len == offset) {
+            res.back().len += len;
+        } else {
+            res.push_back(Extent {.offset = offset, .len = len});
+        }
+    };
+    uint64_t hole_begin = hole.offset;
+    uint64_t hole_end = hole.offset + hole.len;
+    uint64_t pos = 0;
+    for(const Extent& x: xs) {
+        uint64_t begin = pos;
+        uint64_t end = pos + x.len;
+        pos = end;
+        if (end <= hole_begin || begin >= hole_end) {
+            push(x.offset, x.len);
+            continue;
+        }
+        if (begin < hole_begin) {
+            push(x.offset, hole_begin - begin);
+        }
+        if (end > hole_end) {
+            push(x.offset + (hole_end - begin), end - hole_end);
+        }
+    }
+    return res;
+}
+
+}
+
+template<class T>
+requires std::is_trivially_copyable_v<T>
+class Extents {
+public:
+    // maps the file at `path` as a whole, or fails if it is not a whole
+    // number of `T`s.
+    static std::optional<Extents> open(
+        const std::filesystem::path& path,
+        const ExtentsOptions& opts = {}) noexcept
+    {
+        auto mapping = _impl_extents::Mapping::open(path, opts);
+        if (!mapping) {
+            return std::nullopt;
+        }
+        size_t bytes = mapping->bytes().size();
+        if (bytes % sizeof(T) != 0) {
+            return std::nullopt;
+        }
+        std::vector<Extent> extents;
+        if (bytes > 0) {
+            extents.push_back(Extent {.offset = 0, .len = bytes / sizeof(T)});
+        }
+        return Extents(std::move(mapping), std::move(extents));
+    }
+
+    // the same elements of the same file as `xs`, but `extents` of them.
+    Extents(const Extents& xs, std::vector<Extent> extents) noexcept
+    :   Extents(xs._mapping, std::move(extents))
+    {
+        for(const Extent& x: _extents) {
+            FASSERT(x.offset + x.len <= xs._mapping->bytes().size() / sizeof(T));
+        }
+    }
+
+    Extents(const Extents&) noexcept = default;
+    Extents& operator=(const Extents&) noexcept = default;
+    Extents(Extents&&) noexcept = default;
+    Extents& operator=(Extents&&) noexcept = default;
+
+    // the number of elements.
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    std::span<const Extent> extents() const noexcept {
+        return _extents;
+    }
+
+    // calls `f` on consecutive chunks of elements, in order, each of at most
+    // `ExtentsOptions::memory_budget` bytes but at least one element, and
+    // drops their pages after. If `f` returns a bool, false stops it early.
+    // Chunks do not straddle extents, and spans must not outlive calls.
+    template<class F>
+    requires std::invocable<F&, std::span<const T>>
+    void for_each_chunk(F f) const noexcept {
+        size_t chunk = std::max<size_t>(1, _mapping->options().memory_budget / sizeof(T));
+        auto const* elems = reinterpret_cast<const T*>(_mapping->bytes().data());
+        for(const Extent& x: _extents) {
+            for(uint64_t done = 0; done < x.len;) {
+                size_t n = std::min<uint64_t>(chunk, x.len - done);
+                std::span<const T> xs(elems + x.offset + done, n);
+                done += n;
+                bool go_on = true;
+                if constexpr (std::convertible_to<std::invoke_result_t<F&, std::span<const T>>, bool>) {
+                    go_on = f(xs);
+                } else {
+                    f(xs);
+                }
+                _mapping->release(std::as_bytes(xs));
+                if (!go_on) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // writes the elements into a file at `path`, chunk by chunk.
+    bool write(const std::filesystem::path& path) const noexcept {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        for_each_chunk([&](std::span<const T> xs) {
+            auto bytes = std::as_bytes(xs);
+            out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            return static_cast<bool>(out);
+        });
+        out.flush();
+        return static_cast<bool>(out);
+    }
+
+private:
+    Extents(std::shared_ptr<const _impl_extents::Mapping> mapping, std::vector<Extent> extents) noexcept
+    :   _mapping(std::move(mapping)),
+        _extents(std::move(extents))
+    {
+        for(const Extent& x: _extents) {
+            _size += x.len;
+        }
+    }
+
+private:
+    std::shared_ptr<const _impl_extents::Mapping> _mapping;
+    std::vector<Extent> _extents;
+    size_t _size = 0;
+};
+
+namespace _impl_extents {
+
+// Candidates of `Extents<T>` without holes of `LenShrinker` in the same
+// order.
+template<class T>
+struct HoleShrinker {
+    struct Iter {
+        using value_type = Extents<T>;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(const Extents<T>& xs) noexcept
+        :   _xs(&xs),
+            _hole_len(xs.size() / 2)
+        {
+            _check();
+        }
+
+        // starts from the first hole which is not before `start`, and wraps
+        // around to the first hole until it reaches `start` again.
+        // Hole lengths are `size / 2^k`, and offsets are multiples of the
+        // length, so `start` is rounded to the first hole not before it.
+        explicit Iter(const Extents<T>& xs, const _impl_vec::Hole& start) noexcept
+        :   _xs(&xs),
+            _hole_len(xs.size() / 2),
+            _stop(start)
+        {
+            while (_hole_len > start.len) {
+                _hole_len /= 2;
+            }
+            if (_hole_len > 0 && _hole_len == start.len) {
+                _hole_offset = start.offset / _hole_len * _hole_len;
+                if (_hole_offset >= _xs->size()) {
+                    _hole_len /= 2;
+                    _hole_offset = 0;
+                }
+            }
+            _check();
+        }
+
+        value_type operator*() const noexcept {
+            FASSERT(_xs != nullptr);
+            return Extents<T>(*_xs, remove(_xs->extents(), position()));
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_xs != nullptr);
+            _hole_offset += _hole_len;
+            if (_hole_offset >= _xs->size()) {
+                _hole_len /= 2;
+                _hole_offset = 0;
+            }
+            _check();
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        // the hole of the current candidate.
+        _impl_vec::Hole position() const noexcept {
+            FASSERT(_xs != nullptr);
+            return _impl_vec::Hole {
+                .offset = _hole_offset,
+                .len = _hole_len,
+            };
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _xs == ano._xs
+                && _hole_offset == ano._hole_offset
+                && _hole_len == ano._hole_len;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        // Candidates from a start position
+        // * restart from the first hole when holes from the start run out;
+        // * and then stop at the start position.
+        // Otherwise, it becomes the end iterator when holes run out.
+        void _check() noexcept {
+            if (_stop && !_wrapped && _hole_len == 0) {
+                _wrapped = true;
+                _hole_len = _xs->size() / 2;
+                _hole_offset = 0;
+            }
+            if (_wrapped && _hole_len > 0 && !_before(position(), *_stop)) {
+                _hole_len = 0;
+            }
+            if (_hole_len == 0) {
+                *this = Iter();
+            }
+        }
+
+        // the order of holes: larger ones go first.
+        static bool _before(const _impl_vec::Hole& a, const _impl_vec::Hole& b) noexcept {
+            if (a.len != b.len) {
+                return a.len > b.len;
+            }
+            return a.offset < b.offset;
+        }
+
+    private:
+        const Extents<T>* _xs = nullptr;
+        size_t _hole_offset = 0;
+        size_t _hole_len = 0;
+        // for candidates from a start position.
+        std::optional<_impl_vec::Hole> _stop;
+        bool _wrapped = false;
+    };
+
+    explicit HoleShrinker(Extents<T> xs) noexcept
+    :   _xs(std::move(xs))
+    {}
+
+    explicit HoleShrinker(Extents<T> xs, const _impl_vec::Hole& start) noexcept
+    :   _xs(std::move(xs)),
+        _start(start)
+    {}
+
+    HoleShrinker(const HoleShrinker&) = delete;
+    HoleShrinker& operator=(const HoleShrinker&) = delete;
+    HoleShrinker(HoleShrinker&&) noexcept = default;
+    HoleShrinker& operator=(HoleShrinker&&) noexcept = default;
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        if (_start) {
+            return Iter(_xs, *_start);
+        }
+        return Iter(_xs);
+    }
+
+    Iter end() const noexcept {
+        return Iter();
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+private:
+    Extents<T> _xs;
+    std::optional<_impl_vec::Hole> _start;
+};
+
+}
+
+template<class T>
+struct Shrinker<Extents<T>> {
+    explicit Shrinker(Extents<T> xs) noexcept
+    :   _xs(std::move(xs))
+    {}
+
+    using Hint = _impl_vec::Hole;
+
+    _impl_extents::HoleShrinker<T> shrink() && noexcept {
+        return _impl_extents::HoleShrinker<T>(std::move(_xs));
+    }
+
+    // shrinks from `hint`, usually the hole of the last accepted candidate,
+    // so a sweep over a huge file does not retry holes before it.
+    _impl_extents::HoleShrinker<T> shrink(const Hint& hint) && noexcept {
+        return _impl_extents::HoleShrinker<T>(std::move(_xs), hint);
+    }
+
+private:
+    Extents<T> _xs;
+};
+
+}
@@ -0,0 +1,245 @@
+#pragma once
+#include "core.hpp"
+#include "int.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// `float` and `double` shrink towards simple values.
+//
+// Values are ranked from simple to complex, as
+// 1. integers of at most `digits` bits, by magnitude, and then positive
+//    before negative;
+// 2. other finite values, by the number of significant bits, and then by
+//    the distance of their binary exponent from 0, and then positive before
+//    negative;
+// 3. infinities, positive before negative;
+// 4. NaN.
+// Candidates are strictly simpler than the value, so minimization ends.
+// They are, in order,
+// * 0, 1 and -1;
+// * the negation of negative values;
+// * the integral part;
+// * the mantissa truncated to fewer significant bits;
+// * candidates of integers as `int64_t`;
+// * the binary exponent of other finite values shrunk towards 0, as an
+//   integer;
+// * the largest finite value, for infinities, and infinities, for NaN.
+// So a few predicate calls in every round take a value to a simple one,
+// instead of stepping through thousands of denormals.
+//
+// Candidates are computed when the shrinker is created, into a buffer of a
+// fixed capacity, so shrinking allocates nothing.
+
+namespace shrink {
+
+namespace _impl_float {
+
+template<class T>
+concept Float = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template<Float T>
+struct Shrinker {
+    using Bits = std::conditional_t<std::is_same_v<T, float>, uint32_t, uint64_t>;
+    static constexpr int kDigits = std::numeric_limits<T>::digits;
+    static constexpr int kMantissaBits = kDigits - 1;
+    static constexpr int kBias = std::numeric_limits<T>::max_exponent - 1;
+    // specials, and candidates of integers, of mantissae and of exponents.
+    static constexpr size_t kCapacity = 8 + 64 + kDigits + 16;
+
+    using iterator = const T*;
+    using const_iterator = iterator;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator begin() const noexcept {
+        return _cands.data();
+    }
+
+    iterator end() const noexcept {
+        return _cands.data() + _size;
+    }
+
+    iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator cend() const noexcept {
+        return end();
+    }
+
+    explicit Shrinker(T v) noexcept
+    :   _rank(_rank_of(v))
+    {
+        _push(0);
+        _push(1);
+        _push(-1);
+        if (std::isnan(v)) {
+            _push(std::numeric_limits<T>::infinity());
+            _push(-std::numeric_limits<T>::infinity());
+            return;
+        }
+        _push(-v);
+        if (std::isinf(v)) {
+            _push(std::copysign(std::numeric_limits<T>::max(), v));
+            return;
+        }
+        _push(std::trunc(v));
+        if (v == 0) {
+            return;
+        }
+        auto [mantissa, exponent] = _decompose(v);
+        int sig = std::bit_width(mantissa);
+        for(int keep: shrink(sig - 1)) {
+            int drop = sig - 1 - keep;
+            _push(_compose(v, mantissa >> drop, exponent + drop));
+        }
+        if (_is_small_integer(v)) {
+            for(int64_t x: shrink(static_cast<int64_t>(v))) {
+                _push(static_cast<T>(x));
+            }
+            return;
+        }
+        int top = exponent + sig - 1;
+        for(int x: shrink(top)) {
+            _push(_compose(v, mantissa, x - sig + 1));
+        }
+    }
+
+private:
+    struct Rank {
+        int cls = 0;
+        uint64_t major = 0;
+        uint64_t minor = 0;
+        bool negative = false;
+
+        auto operator<=>(const Rank&) const noexcept = default;
+    };
+
+    static bool _is_small_integer(T v) noexcept {
+        return std::isfinite(v)
+            && std::trunc(v) == v
+            && std::fabs(v) < std::ldexp(T(1), kDigits);
+    }
+
+    // `|v| == mantissa * 2^exponent` with an odd mantissa, for finite
+    // non-zero `v`.
+    static std::pair<Bits, int> _decompose(T v) noexcept {
+        Bits bits = std::bit_cast<Bits>(std::fabs(v));
+        auto field = static_cast<int>(bits >> kMantissaBits);
+        Bits mantissa = bits & ((Bits(1) << kMantissaBits) - 1);
+        int exponent = 1 - kBias - kMantissaBits;
+        if (field != 0) {
+            mantissa |= Bits(1) << kMantissaBits;
+            exponent = field - kBias - kMantissaBits;
+        }
+        int tz = std::countr_zero(mantissa);
+        return {mantissa >> tz, exponent + tz};
+    }
+
+    // Both are exact, because candidates are representable.
+    static T _compose(T sign, Bits mantissa, int exponent) noexcept {
+        return std::copysign(std::ldexp(static_cast<T>(mantissa), exponent), sign);
+    }
+
+    static Rank _rank_of(T v) noexcept {
+        bool negative = std::signbit(v);
+        if (std::isnan(v)) {
+            return Rank {.cls = 3};
+        }
+        if (std::isinf(v)) {
+            return Rank {.cls = 2, .negative = negative};
+        }
+        if (_is_small_integer(v)) {
+            return Rank {
+                .cls = 0,
+                .major = static_cast<uint64_t>(std::fabs(v)),
+                .negative = negative,
+            };
+        }
+        auto [mantissa, exponent] = _decompose(v);
+        int sig = std::bit_width(mantissa);
+        int top = exponent + sig - 1;
+        return Rank {
+            .cls = 1,
+            .major = static_cast<uint64_t>(sig),
+            .minor = static_cast<uint64_t>(top < 0 ? -top : top),
+            .negative = negative,
+        };
+    }
+
+    // keeps `x` if it is simpler than the value, and not yet a candidate.
+    void _push(T x) noexcept {
+        if (!(_rank_of(x) < _rank)) {
+            return;
+        }
+        for(size_t i = 0; i < _size; ++i) {
+            if (std::bit_cast<Bits>(_cands[i]) == std::bit_cast<Bits>(x)) {
+                return;
+            }
+        }
+        _impl_constexpr::expect(_size < kCapacity);
+        _cands[_size++] = x;
+    }
+
+private:
+    Rank _rank;
+    std::array<T, kCapacity> _cands {};
+    size_t _size = 0;
+};
+
+}
+
+template<_impl_float::Float T>
+struct Shrinker<T> {
+    explicit Shrinker(T v) noexcept
+    :   _v(v)
+    {}
+
+    _impl_float::Shrinker<T> shrink() && noexcept {
+        return _impl_float::Shrinker<T>(_v);
+    }
+
+private:
+    T _v;
+};
+
+template<_impl_float::Float T>
+struct Serializer<T> {
+    static void write(std::vector<std::byte>& out, T v) noexcept {
+        _impl_serde::write_raw(out, v);
+    }
+
+    static std::optional<T> read(std::span<const std::byte>& in) noexcept {
+        return _impl_serde::read_raw<T>(in);
+    }
+};
+
+template<_impl_float::Float T>
+struct Generator<T> {
+    // * Most values are in `[-size, size]`, half of them integers.
+    // * Special values, i.e., infinities, NaN, the extremes and the smallest
+    //   denormal, come out now and then.
+    static T generate(Random& rng, size_t size) noexcept {
+        using L = std::numeric_limits<T>;
+        static constexpr std::array<T, 7> kSpecials = {
+            L::infinity(), -L::infinity(), L::quiet_NaN(),
+            L::max(), L::lowest(), L::min(), L::denorm_min(),
+        };
+        int dice = std::uniform_int_distribution<int>(0, 7)(rng);
+        if (dice == 0) {
+            return kSpecials[std::uniform_int_distribution<size_t>(0, kSpecials.size() - 1)(rng)];
+        }
+        auto hi = static_cast<T>(size);
+        T x = std::uniform_real_distribution<T>(-hi, hi)(rng);
+        return dice % 2 == 0 ? std::trunc(x) : x;
+    }
+};
+
+}
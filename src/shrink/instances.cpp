@@ -0,0 +1,6 @@
+// Definitions of the instantiations which instances.hpp declares `extern`.
+// It is built only with the CMake option `SHRINK_EXPLICIT_INSTANTIATION`.
+#include "shrink/instances.hpp"
+
+SHRINK_FOR_EACH_VEC_INSTANCE(SHRINK_INSTANTIATE_VEC)
+SHRINK_FOR_EACH_SPAN_INSTANCE(SHRINK_INSTANTIATE_SPAN)
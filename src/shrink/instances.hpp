@@ -0,0 +1,65 @@
+#pragma once
+#include "core.hpp"
+#include "int.hpp"
+#include "vec.hpp"
+#include "span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Explicit instantiations of shrinkers of common types, i.e., vectors of
+// integers and spans of bytes.
+//
+// Shrinkers are header-only templates, so every translation unit which
+// shrinks a `std::vector<int>` instantiates `ChainShrinker<int>` and
+// friends again. If `SHRINK_EXTERN_TEMPLATES` is defined, e.g., by the CMake
+// option `SHRINK_EXPLICIT_INSTANTIATION`, vec.hpp and span.hpp include this
+// header, which declares these instantiations `extern`, and instances.cpp
+// defines them once for the whole program.
+//
+// Other types are instantiated implicitly as usual.
+
+#define SHRINK_FOR_EACH_VEC_INSTANCE(X) \
+    X(char) \
+    X(int8_t) \
+    X(uint8_t) \
+    X(int16_t) \
+    X(uint16_t) \
+    X(int32_t) \
+    X(uint32_t) \
+    X(int64_t) \
+    X(uint64_t) \
+    X(std::byte)
+
+#define SHRINK_FOR_EACH_SPAN_INSTANCE(X) \
+    X(char) \
+    X(const char) \
+    X(uint8_t) \
+    X(const uint8_t) \
+    X(std::byte) \
+    X(const std::byte)
+
+// `DECL` is either `template`, which defines the instantiations, or
+// `extern template`, which declares them.
+#define SHRINK_VEC_INSTANCES(DECL, T) \
+    DECL struct ::shrink::_impl_vec::LenShrinker<T>; \
+    DECL struct ::shrink::_impl_vec::ElemShrinker<T>; \
+    DECL struct ::shrink::_impl_vec::ChainShrinker<T>; \
+    DECL struct ::shrink::Shrinker<std::vector<T>>; \
+    DECL struct ::shrink::Serializer<std::vector<T>>; \
+    DECL struct ::shrink::Generator<std::vector<T>>;
+
+#define SHRINK_SPAN_INSTANCES(DECL, T) \
+    DECL struct ::shrink::_impl_span::ContiguousShrinker<T, std::dynamic_extent>; \
+    DECL struct ::shrink::Shrinker<std::span<T>>;
+
+#define SHRINK_EXTERN_VEC(T) SHRINK_VEC_INSTANCES(extern template, T)
+#define SHRINK_EXTERN_SPAN(T) SHRINK_SPAN_INSTANCES(extern template, T)
+#define SHRINK_INSTANTIATE_VEC(T) SHRINK_VEC_INSTANCES(template, T)
+#define SHRINK_INSTANTIATE_SPAN(T) SHRINK_SPAN_INSTANCES(template, T)
+
+#ifdef SHRINK_EXTERN_TEMPLATES
+SHRINK_FOR_EACH_VEC_INSTANCE(SHRINK_EXTERN_VEC)
+SHRINK_FOR_EACH_SPAN_INSTANCE(SHRINK_EXTERN_SPAN)
+#endif
@@ -1,9 +1,11 @@
 #pragma once
 #include "core.hpp"
-#include "fassert.hpp"
 #include <optional>
 #include <type_traits>
+#include <limits>
+#include <random>
 #include <cstddef>
+#include <cstdint>
 
 namespace shrink {
 
@@ -16,16 +18,16 @@ struct Shrinker {
         using value_type = T;
         using difference_type = std::ptrdiff_t;
 
-        Iter(const Iter&) noexcept = default;
-        Iter& operator=(const Iter&) noexcept = default;
-        Iter(Iter&&) noexcept = default;
-        Iter& operator=(Iter&&) noexcept = default;
+        constexpr Iter(const Iter&) noexcept = default;
+        constexpr Iter& operator=(const Iter&) noexcept = default;
+        constexpr Iter(Iter&&) noexcept = default;
+        constexpr Iter& operator=(Iter&&) noexcept = default;
 
-        Iter() noexcept
+        constexpr Iter() noexcept
         :   _state(std::nullopt)
         {}
 
-        explicit Iter(T v) noexcept
+        constexpr explicit Iter(T v) noexcept
         :   _state(_State(v))
         {
             if (_state->is_exhausted()) {
@@ -33,13 +35,13 @@ struct Shrinker {
             }
         }
 
-        T operator*() const noexcept {
-            FASSERT(_state);
+        constexpr T operator*() const noexcept {
+            _impl_constexpr::expect(_state.has_value());
             return **_state;
         }
 
-        Iter& operator++() noexcept {
-            FASSERT(_state);
+        constexpr Iter& operator++() noexcept {
+            _impl_constexpr::expect(_state.has_value());
             bool has_next = _state->next();
             if (!has_next) {
                 _state.reset();
@@ -47,46 +49,46 @@ struct Shrinker {
             return *this;
         }
 
-        Iter operator++(int) noexcept {
+        constexpr Iter operator++(int) noexcept {
             Iter copied(*this);
             ++(*this);
             return copied;
         }
 
-        bool operator==(const Iter& ano) const noexcept {
+        constexpr bool operator==(const Iter& ano) const noexcept {
             return _state == ano._state;
         }
 
-        bool operator!=(const Iter&) const noexcept = default;
+        constexpr bool operator!=(const Iter&) const noexcept = default;
 
     private:
         struct _State {
             T init;
             T complement;
 
-            explicit _State(T v) noexcept
+            constexpr explicit _State(T v) noexcept
             :   init(v),
                 complement(v)
             {}
 
-            T operator*() const noexcept {
+            constexpr T operator*() const noexcept {
                 return init - complement;
             }
 
-            bool next() noexcept {
+            constexpr bool next() noexcept {
                 complement /= 2;
                 return !is_exhausted();
             }
 
-            bool is_exhausted() const noexcept {
+            constexpr bool is_exhausted() const noexcept {
                 return complement == 0;
             }
 
-            bool operator==(const _State& ano) const noexcept {
+            constexpr bool operator==(const _State& ano) const noexcept {
                 return init == ano.init && complement == ano.complement;
             }
 
-            bool operator!=(const _State& ano) const noexcept = default;
+            constexpr bool operator!=(const _State& ano) const noexcept = default;
         };
 
         std::optional<_State> _state;
@@ -97,23 +99,23 @@ struct Shrinker {
     using value_type = Iter::value_type;
     using difference_type = Iter::difference_type;
 
-    Iter begin() const noexcept {
+    constexpr Iter begin() const noexcept {
         return Iter(_v);
     }
 
-    Iter end() const noexcept {
+    constexpr Iter end() const noexcept {
         return Iter();
     }
 
-    Iter cbegin() const noexcept {
+    constexpr Iter cbegin() const noexcept {
         return begin();
     }
 
-    Iter cend() const noexcept {
+    constexpr Iter cend() const noexcept {
         return end();
     }
 
-    explicit Shrinker(T v) noexcept
+    constexpr explicit Shrinker(T v) noexcept
     :   _v(v)
     {}
 
@@ -126,11 +128,11 @@ private:
 template<class T>
 requires std::is_integral_v<T>
 struct Shrinker<T> {
-    explicit Shrinker(T v) noexcept
+    constexpr explicit Shrinker(T v) noexcept
     :   _v(v)
     {}
 
-    _impl_int::Shrinker<T> shrink() && noexcept {
+    constexpr _impl_int::Shrinker<T> shrink() && noexcept {
         _impl_int::Shrinker<T> x(_v);
         return x;
     }
@@ -139,14 +141,70 @@ private:
     T _v;
 };
 
+template<class T>
+requires std::is_integral_v<T>
+struct Serializer<T> {
+    static void write(std::vector<std::byte>& out, T v) noexcept {
+        _impl_serde::write_raw(out, v);
+    }
+
+    static std::optional<T> read(std::span<const std::byte>& in) noexcept {
+        return _impl_serde::read_raw<T>(in);
+    }
+};
+
+template<class T>
+requires std::is_integral_v<T>
+struct Generator<T> {
+    // * Most values are in `[-size, size]`, so that small values come out
+    //   often.
+    // * Values in the whole range of `T` come out now and then.
+    static T generate(Random& rng, size_t size) noexcept {
+        if constexpr (std::is_same_v<T, bool>) {
+            return std::bernoulli_distribution()(rng);
+        } else {
+            // `uniform_int_distribution` does not accept character types.
+            using W = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+            using Dist = std::uniform_int_distribution<W>;
+            if (std::uniform_int_distribution<int>(0, 3)(rng) == 0) {
+                return static_cast<T>(Dist(
+                    std::numeric_limits<T>::min(),
+                    std::numeric_limits<T>::max())(rng));
+            }
+            constexpr auto kMax = static_cast<uint64_t>(std::numeric_limits<T>::max());
+            W hi = static_cast<W>(size < kMax ? size : kMax);
+            W lo = std::is_signed_v<T> ? -hi : 0;
+            return static_cast<T>(Dist(lo, hi)(rng));
+        }
+    }
+};
+
 template<>
 struct Shrinker<std::byte> {
-    explicit Shrinker(std::byte) noexcept
+    constexpr explicit Shrinker(std::byte) noexcept
     {}
 
-    _EmptyShrinkerImpl<std::byte> shrink() && noexcept {
+    constexpr _EmptyShrinkerImpl<std::byte> shrink() && noexcept {
         return _EmptyShrinkerImpl<std::byte>();
     }
 };
 
+template<>
+struct Generator<std::byte> {
+    static std::byte generate(Random& rng, size_t) noexcept {
+        return static_cast<std::byte>(std::uniform_int_distribution<int>(0, 255)(rng));
+    }
+};
+
+template<>
+struct Serializer<std::byte> {
+    static void write(std::vector<std::byte>& out, std::byte v) noexcept {
+        out.push_back(v);
+    }
+
+    static std::optional<std::byte> read(std::span<const std::byte>& in) noexcept {
+        return _impl_serde::read_raw<std::byte>(in);
+    }
+};
+
 }
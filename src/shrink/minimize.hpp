@@ -0,0 +1,461 @@
+#pragma once
+#include "core.hpp"
+#include "trace.hpp"
+#include "fassert.hpp"
+#include <concepts>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace shrink {
+
+struct MinimizeOptions {
+    // Where to persist the state of the minimization.
+    // * Checkpointing is disabled if it is empty.
+    // * If it names a checkpoint of the same initial value, the minimization
+    //   resumes from there.
+    // * It requires `Serializable<T>`.
+    std::filesystem::path checkpoint_path;
+    // Number of predicate calls between two successive checkpoints.
+    size_t checkpoint_interval = 64;
+    // Whether every round starts from the position of the candidate accepted
+    // in the previous round, rather than from the first candidate.
+    // It takes effect on types whose shrinkers accept a hint, e.g., vectors.
+    bool resume = false;
+};
+
+struct MinimizeStats {
+    size_t predicate_calls = 0;
+    size_t accepted = 0;
+};
+
+// The positions of accepted candidates, one per round, among candidates of
+// the round, e.g., the position in the chain of passes of a vector, which
+// tells the pass and the index.
+// Replaying it by `replay()` rebuilds the minimized value from the initial
+// one without calling the predicate.
+struct DecisionLog {
+    std::vector<uint64_t> positions;
+
+    bool operator==(const DecisionLog&) const noexcept = default;
+};
+
+template<>
+struct Serializer<DecisionLog> {
+    // Positions are mostly small, so they are varints.
+    static void write(std::vector<std::byte>& out, const DecisionLog& log) noexcept {
+        _impl_serde::write_varint(out, log.positions.size());
+        for(uint64_t x: log.positions) {
+            _impl_serde::write_varint(out, x);
+        }
+    }
+
+    static std::optional<DecisionLog> read(std::span<const std::byte>& in) noexcept {
+        auto n = _impl_serde::read_varint(in);
+        // Every position takes a byte at least.
+        if (!n || *n > in.size()) {
+            return std::nullopt;
+        }
+        DecisionLog res;
+        for(uint64_t i = 0; i < *n; ++i) {
+            auto x = _impl_serde::read_varint(in);
+            if (!x) {
+                return std::nullopt;
+            }
+            res.positions.push_back(*x);
+        }
+        return res;
+    }
+};
+
+template<class T>
+struct Minimized {
+    T value;
+    MinimizeStats stats;
+    DecisionLog decisions;
+};
+
+template<class T>
+struct Checkpoint {
+    // digest of the serialized initial value, in order to reject checkpoints
+    // of other minimizations.
+    uint64_t origin = 0;
+    // the smallest failing value so far.
+    T value;
+    // number of candidates of `value` which are already evaluated.
+    uint64_t position = 0;
+    MinimizeStats stats;
+    // the serialized hint where candidates of `value` start, or empty if they
+    // start from the first one. See `MinimizeOptions::resume`.
+    std::vector<std::byte> hint;
+    // decisions up to `value`.
+    DecisionLog decisions;
+};
+
+namespace _impl_minimize {
+
+constexpr std::string_view kCheckpointMagic = "SHRKCKPT";
+constexpr uint32_t kCheckpointVersion = 3;
+
+// Whether shrinkers of `T` can start from a hint, which is the position of
+// a candidate.
+template<class T>
+concept Resumable = requires {
+        typename Shrinker<T>::Hint;
+    }
+    && requires(Shrinker<T> s, const typename Shrinker<T>::Hint& hint) {
+        { std::move(s).shrink(hint) } noexcept
+            -> std::same_as<decltype(std::move(s).shrink())>;
+        { std::move(s).shrink().begin().position() } noexcept
+            -> std::same_as<typename Shrinker<T>::Hint>;
+    };
+
+template<class T>
+struct HintOf {
+    using type = std::monostate;
+};
+
+template<Resumable T>
+struct HintOf<T> {
+    using type = typename Shrinker<T>::Hint;
+};
+
+template<class T>
+auto candidates(
+    const T& cur,
+    const std::optional<typename HintOf<T>::type>& hint) noexcept
+{
+    Shrinker<T> x(cur);
+    if constexpr (Resumable<T>) {
+        if (hint) {
+            return std::move(x).shrink(*hint);
+        }
+    }
+    return std::move(x).shrink();
+}
+
+inline uint64_t digest(std::span<const std::byte> xs) noexcept {
+    // FNV-1a
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(std::byte x: xs) {
+        h ^= std::to_integer<uint64_t>(x);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+template<Serializable T>
+uint64_t digest_of(const T& v) noexcept {
+    std::vector<std::byte> buf;
+    Serializer<T>::write(buf, v);
+    return digest(buf);
+}
+
+inline bool write_file(
+    const std::filesystem::path& path,
+    std::span<const std::byte> content) noexcept
+{
+    // writes a sibling file and then renames it, so a preempted writer never
+    // leaves a torn file behind.
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(
+            reinterpret_cast<const char*>(content.data()),
+            content.size());
+        out.flush();
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+inline std::optional<std::vector<std::byte>> read_file(
+    const std::filesystem::path& path) noexcept
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::vector<char> buf(
+        (std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        return std::nullopt;
+    }
+    auto const* p = reinterpret_cast<const std::byte*>(buf.data());
+    return std::vector<std::byte>(p, p + buf.size());
+}
+
+}
+
+template<Serializable T>
+bool save_checkpoint(
+    const std::filesystem::path& path,
+    const Checkpoint<T>& ckpt) noexcept
+{
+    std::vector<std::byte> buf;
+    auto const* magic =
+        reinterpret_cast<const std::byte*>(_impl_minimize::kCheckpointMagic.data());
+    buf.insert(buf.end(), magic, magic + _impl_minimize::kCheckpointMagic.size());
+    _impl_serde::write_raw(buf, _impl_minimize::kCheckpointVersion);
+    _impl_serde::write_raw(buf, ckpt.origin);
+    _impl_serde::write_raw(buf, ckpt.position);
+    _impl_serde::write_raw(buf, static_cast<uint64_t>(ckpt.stats.predicate_calls));
+    _impl_serde::write_raw(buf, static_cast<uint64_t>(ckpt.stats.accepted));
+    _impl_serde::write_raw(buf, static_cast<uint64_t>(ckpt.hint.size()));
+    buf.insert(buf.end(), ckpt.hint.begin(), ckpt.hint.end());
+    Serializer<DecisionLog>::write(buf, ckpt.decisions);
+    Serializer<T>::write(buf, ckpt.value);
+    return _impl_minimize::write_file(path, buf);
+}
+
+template<Serializable T>
+std::optional<Checkpoint<T>> load_checkpoint(
+    const std::filesystem::path& path) noexcept
+{
+    auto buf = _impl_minimize::read_file(path);
+    if (!buf) {
+        return std::nullopt;
+    }
+    std::span<const std::byte> in(*buf);
+    auto magic = _impl_minimize::kCheckpointMagic;
+    if (in.size() < magic.size()
+        || std::memcmp(in.data(), magic.data(), magic.size()) != 0)
+    {
+        return std::nullopt;
+    }
+    in = in.subspan(magic.size());
+    auto version = _impl_serde::read_raw<uint32_t>(in);
+    if (!version || *version != _impl_minimize::kCheckpointVersion) {
+        return std::nullopt;
+    }
+    auto origin = _impl_serde::read_raw<uint64_t>(in);
+    auto position = _impl_serde::read_raw<uint64_t>(in);
+    auto calls = _impl_serde::read_raw<uint64_t>(in);
+    auto accepted = _impl_serde::read_raw<uint64_t>(in);
+    auto hint_len = _impl_serde::read_raw<uint64_t>(in);
+    if (!origin || !position || !calls || !accepted || !hint_len || in.size() < *hint_len) {
+        return std::nullopt;
+    }
+    std::vector<std::byte> hint(in.begin(), in.begin() + *hint_len);
+    in = in.subspan(*hint_len);
+    auto decisions = Serializer<DecisionLog>::read(in);
+    if (!decisions) {
+        return std::nullopt;
+    }
+    auto value = Serializer<T>::read(in);
+    if (!value || !in.empty()) {
+        return std::nullopt;
+    }
+    return Checkpoint<T> {
+        .origin = *origin,
+        .value = std::move(*value),
+        .position = *position,
+        .stats = MinimizeStats {
+            .predicate_calls = *calls,
+            .accepted = *accepted,
+        },
+        .hint = std::move(hint),
+        .decisions = std::move(*decisions),
+    };
+}
+
+// Greedily minimizes `init`.
+// `pred` returns true iff a candidate still fails in the interesting way.
+// In every round, the first candidate of the current value which satisfies
+// `pred` is accepted; the minimization stops when no candidate does.
+// Every round and candidate is reported to `tracer`. See trace.hpp.
+// Positions of accepted candidates are logged into `decisions` of the result.
+template<Shrinkable T, class Pred, TracePolicy Tracer>
+requires std::predicate<Pred&, const T&>
+Minimized<T> minimize(
+    T init,
+    Pred pred,
+    const MinimizeOptions& opts,
+    Tracer& tracer) noexcept
+{
+    constexpr bool kTraced = Tracer::kEnabled;
+    using Hint = typename _impl_minimize::HintOf<T>::type;
+    constexpr bool kResumable = _impl_minimize::Resumable<T>;
+    constexpr bool kCheckpointable = Serializable<T>
+        && (!kResumable || Serializable<Hint>);
+    bool checkpointing = !opts.checkpoint_path.empty();
+    FASSERT(!checkpointing || kCheckpointable);
+
+    uint64_t origin = 0;
+    uint64_t skip = 0;
+    MinimizeStats stats;
+    DecisionLog decisions;
+    std::optional<Hint> hint;
+    if constexpr (kCheckpointable) {
+        if (checkpointing) {
+            origin = _impl_minimize::digest_of(init);
+            auto ckpt = load_checkpoint<T>(opts.checkpoint_path);
+            if (ckpt && ckpt->origin == origin) {
+                init = std::move(ckpt->value);
+                skip = ckpt->position;
+                stats = ckpt->stats;
+                decisions = std::move(ckpt->decisions);
+                if constexpr (kResumable) {
+                    if (!ckpt->hint.empty()) {
+                        std::span<const std::byte> in(ckpt->hint);
+                        hint = Serializer<Hint>::read(in);
+                    }
+                }
+            }
+        }
+    }
+
+    T cur = std::move(init);
+    size_t calls_since_checkpoint = 0;
+    auto save = [&](uint64_t position) noexcept {
+        if constexpr (kCheckpointable) {
+            Checkpoint<T> ckpt {
+                .origin = origin,
+                .value = cur,
+                .position = position,
+                .stats = stats,
+                .decisions = decisions,
+            };
+            if constexpr (kResumable) {
+                if (hint) {
+                    Serializer<Hint>::write(ckpt.hint, *hint);
+                }
+            }
+            save_checkpoint(opts.checkpoint_path, ckpt);
+            calls_since_checkpoint = 0;
+        }
+    };
+
+    for(bool accepted = true; accepted;) {
+        accepted = false;
+        TraceMark round_mark;
+        TraceMark mark;
+        std::string_view pass;
+        if constexpr (kTraced) {
+            round_mark = TraceMark::now();
+            mark = round_mark;
+        }
+        auto candidates = _impl_minimize::candidates(cur, hint);
+        auto it = candidates.begin();
+        auto end = candidates.end();
+        uint64_t position = 0;
+        // Candidates evaluated before the checkpoint are skipped without
+        // being materialized.
+        for(; position < skip && it != end; ++position, ++it) {
+        }
+        skip = 0;
+        for(; it != end; ++position, ++it) {
+            if constexpr (kTraced) {
+                pass = _impl_trace::pass_of(it);
+                mark = tracer.record(TracePhase::kStep, mark, pass, 0, false);
+            }
+            T cand = *it;
+            if constexpr (kTraced) {
+                mark = tracer.record(TracePhase::kConstruct, mark, pass, 0, false);
+            }
+            ++stats.predicate_calls;
+            ++calls_since_checkpoint;
+            bool holds = pred(std::as_const(cand));
+            if constexpr (kTraced) {
+                mark = tracer.record(
+                    TracePhase::kPredicate, mark, pass, _impl_trace::size_of(cand), holds);
+            }
+            if (holds) {
+                ++stats.accepted;
+                decisions.positions.push_back(position);
+                cur = std::move(cand);
+                accepted = true;
+                if constexpr (kResumable) {
+                    if (opts.resume) {
+                        hint = it.position();
+                    }
+                }
+            }
+            if (checkpointing && calls_since_checkpoint >= opts.checkpoint_interval) {
+                save(accepted ? 0 : position + 1);
+            }
+            if (accepted) {
+                break;
+            }
+        }
+        if (checkpointing && !accepted) {
+            save(position);
+        }
+        if constexpr (kTraced) {
+            tracer.record(TracePhase::kRound, round_mark, "", 0, accepted);
+        }
+    }
+
+    return Minimized<T> {
+        .value = std::move(cur),
+        .stats = stats,
+        .decisions = std::move(decisions),
+    };
+}
+
+// Minimizes `init` without tracing.
+template<Shrinkable T, class Pred>
+requires std::predicate<Pred&, const T&>
+Minimized<T> minimize(
+    T init,
+    Pred pred,
+    const MinimizeOptions& opts = {}) noexcept
+{
+    NullTracer tracer;
+    return minimize(std::move(init), std::move(pred), opts, tracer);
+}
+
+// Rebuilds the result of a minimization of `init` from its decisions,
+// without calling the predicate.
+// `opts.resume` must be that of the minimization; other options are
+// ignored. Returns nothing if the log does not fit `init`, i.e., a position
+// is beyond candidates of its round.
+template<Shrinkable T>
+std::optional<T> replay(
+    T init,
+    const DecisionLog& log,
+    const MinimizeOptions& opts = {}) noexcept
+{
+    using Hint = typename _impl_minimize::HintOf<T>::type;
+    T cur = std::move(init);
+    std::optional<Hint> hint;
+    for(uint64_t position: log.positions) {
+        auto candidates = _impl_minimize::candidates(cur, hint);
+        auto it = candidates.begin();
+        auto end = candidates.end();
+        for(uint64_t i = 0; i < position && it != end; ++i, ++it) {
+        }
+        if (it == end) {
+            return std::nullopt;
+        }
+        T next = *it;
+        if constexpr (_impl_minimize::Resumable<T>) {
+            if (opts.resume) {
+                hint = it.position();
+            }
+        }
+        cur = std::move(next);
+    }
+    return cur;
+}
+
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include "core.hpp"
+#include "vec.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <functional>
+#include <map>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+// Minimization of vectors of independent sub-cases, e.g., batches of
+// transactions where a failure needs only a few of them.
+//
+// A partitioning function maps every element to a key. Elements are regrouped
+// by key: partitions go in the order of their first elements, and elements
+// of a partition keep their order. Then
+// 1. partitions which the failure does not need are removed, as a whole;
+// 2. every needed partition is minimized on its own thread, while the
+//    others are held as they are;
+// 3. the minimized partitions are merged and verified. If partitions turn
+//    out not to be independent, i.e., the merge does not fail, minimization
+//    falls back to the result of step 1;
+// 4. the merge is polished by `minimize()`, so no candidate of the result
+//    fails, as with `minimize()`.
+// If the input does not fail after regrouping, it is minimized by
+// `minimize()` as it is.
+//
+// `pred` must be safe to call concurrently.
+
+namespace shrink {
+
+struct PartitionOptions {
+    // Number of threads minimizing partitions. 0 means the number of cores.
+    size_t threads = 0;
+};
+
+template<class T>
+struct PartitionMinimized {
+    T value;
+    MinimizeStats stats;
+    // number of partitions of the input, and of those the failure needs.
+    size_t partitions = 0;
+    size_t needed = 0;
+    // whether merging independently minimized partitions fails, i.e.,
+    // partitions are independent as the partitioning function claims.
+    bool independent = false;
+};
+
+namespace _impl_partition {
+
+inline void add(MinimizeStats& to, const MinimizeStats& from) noexcept {
+    to.predicate_calls += from.predicate_calls;
+    to.accepted += from.accepted;
+}
+
+template<class T>
+std::vector<T> concat(const std::vector<std::vector<T>>& parts) noexcept {
+    std::vector<T> res;
+    for(auto const& part: parts) {
+        res.insert(res.end(), part.begin(), part.end());
+    }
+    return res;
+}
+
+}
+
+template<Shrinkable T, class Part, class Pred>
+requires std::invocable<Part&, const T&>
+    && std::totally_ordered<std::remove_cvref_t<std::invoke_result_t<Part&, const T&>>>
+    && std::predicate<Pred&, const std::vector<T>&>
+PartitionMinimized<std::vector<T>> minimize_partitioned(
+    std::vector<T> init,
+    Part part,
+    Pred pred,
+    const PartitionOptions& opts = {}) noexcept
+{
+    using namespace _impl_partition;
+    using Key = std::remove_cvref_t<std::invoke_result_t<Part&, const T&>>;
+    PartitionMinimized<std::vector<T>> res;
+
+    std::vector<std::vector<T>> parts;
+    {
+        std::map<Key, size_t> index;
+        for(T& x: init) {
+            auto [it, fresh] = index.try_emplace(std::invoke(part, std::as_const(x)), parts.size());
+            if (fresh) {
+                parts.emplace_back();
+            }
+            parts[it->second].push_back(std::move(x));
+        }
+    }
+    res.partitions = parts.size();
+    std::vector<T> regrouped = concat(parts);
+    ++res.stats.predicate_calls;
+    if (!pred(std::as_const(regrouped))) {
+        // The order of elements matters, so partitions are not independent.
+        auto minimized = minimize(std::move(regrouped), pred);
+        res.value = std::move(minimized.value);
+        add(res.stats, minimized.stats);
+        return res;
+    }
+
+    // 1. finds needed partitions.
+    std::vector<Unshrink<size_t>> ids;
+    for(size_t i = 0; i < parts.size(); ++i) {
+        ids.push_back(unshrink(i));
+    }
+    auto select = [&](const std::vector<Unshrink<size_t>>& ids) noexcept {
+        std::vector<std::vector<T>> res;
+        for(auto const& id: ids) {
+            res.push_back(parts[id.v]);
+        }
+        return res;
+    };
+    auto needed = minimize(std::move(ids), [&](const std::vector<Unshrink<size_t>>& ids) {
+        const std::vector<T> xs = concat(select(ids));
+        return pred(xs);
+    });
+    add(res.stats, needed.stats);
+    std::vector<std::vector<T>> kept = select(needed.value);
+    res.needed = kept.size();
+
+    // 2. minimizes needed partitions concurrently.
+    std::vector<std::optional<Minimized<std::vector<T>>>> minimized(kept.size());
+    std::atomic<size_t> next {0};
+    auto work = [&]() noexcept {
+        for(;;) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= kept.size()) {
+                return;
+            }
+            minimized[i] = minimize(kept[i], [&, i](const std::vector<T>& xs) {
+                std::vector<T> merged;
+                for(size_t j = 0; j < kept.size(); ++j) {
+                    auto const& part = j == i ? xs : kept[j];
+                    merged.insert(merged.end(), part.begin(), part.end());
+                }
+                return pred(std::as_const(merged));
+            });
+        }
+    };
+    size_t threads = opts.threads > 0
+        ? opts.threads
+        : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::min(threads, std::max<size_t>(kept.size(), 1));
+    {
+        std::vector<std::jthread> workers;
+        for(size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+    }
+
+    // 3. merges and verifies.
+    std::vector<std::vector<T>> merged;
+    for(auto& m: minimized) {
+        FASSERT(m);
+        add(res.stats, m->stats);
+        merged.push_back(std::move(m->value));
+    }
+    std::vector<T> cur = concat(merged);
+    ++res.stats.predicate_calls;
+    res.independent = pred(std::as_const(cur));
+    if (!res.independent) {
+        cur = concat(kept);
+    }
+
+    // 4. polishes.
+    auto polished = minimize(std::move(cur), pred);
+    add(res.stats, polished.stats);
+    res.value = std::move(polished.value);
+    return res;
+}
+
+}
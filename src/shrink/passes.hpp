@@ -0,0 +1,284 @@
+#pragma once
+#include "core.hpp"
+#include "vec.hpp"
+#include "fassert.hpp"
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Vector shrinking as an ordered list of passes, e.g.,
+//
+//     template<>
+//     struct shrink::Shrinker<Batch> {
+//         ...
+//         auto shrink() && noexcept {
+//             return shrink::map(
+//                 shrink::vec_passes(
+//                     std::move(_batch.txs),
+//                     shrink::removal_pass,
+//                     merge_adjacent_txs,
+//                     shrink::elem_pass),
+//                 [](std::vector<Tx> txs) { return Batch {.txs = std::move(txs)}; });
+//         }
+//         ...
+//     };
+//
+// A pass is a callable which takes the vector and returns a forward range of
+// candidates. Built-in ones are
+// * `removal_pass`, which removes consecutive elements as `LenShrinker` does,
+// * and `elem_pass`, which shrinks one element as `ElemShrinker` does.
+// `vec_passes(xs, removal_pass, elem_pass)` yields the candidates of
+// `shrink(xs)`.
+//
+// A pass is called only when the previous ones run out of candidates, so a
+// greedy step which accepts an early candidate never sets up later passes.
+// A pass whose range is not borrowed is kept alive by iterators in it.
+// Like `ChainShrinker`, iterators must not outlive the range, nor survive
+// moving it.
+
+namespace shrink {
+
+namespace _impl_vec {
+
+struct RemovalPass {
+    static constexpr std::string_view name = "len";
+
+    template<class T>
+    LenShrinker<T> operator()(const std::vector<T>& xs) const noexcept {
+        return LenShrinker<T>(xs);
+    }
+};
+
+struct ElemPass {
+    static constexpr std::string_view name = "elem";
+
+    template<Shrinkable T>
+    ElemShrinker<T> operator()(const std::vector<T>& xs) const noexcept {
+        return ElemShrinker<T>(xs);
+    }
+};
+
+template<class T, class... Passes>
+struct PassShrinker {
+    static constexpr size_t kPasses = sizeof...(Passes);
+
+    explicit PassShrinker(std::vector<T> xs, Passes... passes) noexcept
+    :   _xs(std::move(xs)),
+        _passes(std::move(passes)...)
+    {}
+
+    PassShrinker(const PassShrinker&) = delete;
+    PassShrinker& operator=(const PassShrinker&) = delete;
+    PassShrinker(PassShrinker&&) noexcept = default;
+    PassShrinker& operator=(PassShrinker&&) noexcept = default;
+
+private:
+    template<size_t I>
+    using _Pass = std::tuple_element_t<I, std::tuple<Passes...>>;
+
+    template<size_t I>
+    using _Range = std::remove_cvref_t<std::invoke_result_t<const _Pass<I>&, const std::vector<T>&>>;
+
+    // the remaining candidates of a pass, and the range which owns them
+    // unless it is borrowed.
+    template<size_t I>
+    struct _Stage {
+        using Range = _Range<I>;
+        using RangeIter = std::ranges::iterator_t<const Range>;
+
+        std::shared_ptr<const Range> range;
+        RangeIter it;
+        RangeIter end;
+
+        bool operator==(const _Stage& ano) const noexcept {
+            return it == ano.it;
+        }
+    };
+
+    template<size_t... Is>
+    static auto _stages(std::index_sequence<Is...>)
+        -> std::variant<std::monostate, _Stage<Is>...>;
+
+    using _Stages = decltype(_stages(std::make_index_sequence<kPasses>()));
+
+    // calls `f.template operator()<I>()` for `I == i`.
+    template<class F>
+    static void _dispatch(size_t i, F&& f) noexcept {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((i == Is ? (f.template operator()<Is>(), 0) : 0), ...);
+        }(std::make_index_sequence<kPasses>());
+    }
+
+public:
+    struct Iter {
+        using value_type = std::vector<T>;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        explicit Iter(const PassShrinker& owner) noexcept
+        :   _owner(&owner)
+        {
+            _start(0);
+        }
+
+        value_type operator*() const noexcept {
+            FASSERT(_owner != nullptr);
+            value_type res;
+            _dispatch(_pass, [&]<size_t I>() {
+                res = *std::get<I + 1>(_stage).it;
+            });
+            return res;
+        }
+
+        // materializes the current candidate into `out`, reusing its buffer
+        // if the pass can.
+        void materialize(value_type& out) const noexcept {
+            FASSERT(_owner != nullptr);
+            _dispatch(_pass, [&]<size_t I>() {
+                auto const& it = std::get<I + 1>(_stage).it;
+                if constexpr (requires { it.materialize(out); }) {
+                    it.materialize(out);
+                } else {
+                    out = *it;
+                }
+            });
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_owner != nullptr);
+            bool exhausted = false;
+            _dispatch(_pass, [&]<size_t I>() {
+                auto& stage = std::get<I + 1>(_stage);
+                ++stage.it;
+                exhausted = stage.it == stage.end;
+            });
+            if (exhausted) {
+                _start(_pass + 1);
+            }
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        // the index of the pass of the current candidate.
+        size_t pass() const noexcept {
+            FASSERT(_owner != nullptr);
+            return _pass;
+        }
+
+        // the name of the pass of the current candidate, for tracing.
+        std::string_view pass_name() const noexcept {
+            FASSERT(_owner != nullptr);
+            std::string_view res = "pass";
+            _dispatch(_pass, [&]<size_t I>() {
+                if constexpr (requires { { _Pass<I>::name } -> std::convertible_to<std::string_view>; }) {
+                    res = _Pass<I>::name;
+                }
+            });
+            return res;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _owner == ano._owner && _pass == ano._pass && _stage == ano._stage;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        // starts the first pass, from the `pass`-th on, which has candidates,
+        // or becomes the end iterator if none has.
+        void _start(size_t pass) noexcept {
+            for(; pass < kPasses; ++pass) {
+                bool started = false;
+                _dispatch(pass, [&]<size_t I>() {
+                    using Stage = _Stage<I>;
+                    using Range = typename Stage::Range;
+                    auto const& f = std::get<I>(_owner->_passes);
+                    Stage stage;
+                    if constexpr (std::ranges::borrowed_range<Range>) {
+                        const Range range = f(_owner->_xs);
+                        stage.it = std::ranges::begin(range);
+                        stage.end = std::ranges::end(range);
+                    } else {
+                        stage.range = std::make_shared<const Range>(f(_owner->_xs));
+                        stage.it = std::ranges::begin(*stage.range);
+                        stage.end = std::ranges::end(*stage.range);
+                    }
+                    if (stage.it != stage.end) {
+                        _stage.template emplace<I + 1>(std::move(stage));
+                        started = true;
+                    }
+                });
+                if (started) {
+                    _pass = pass;
+                    return;
+                }
+            }
+            *this = Iter();
+        }
+
+    private:
+        const PassShrinker* _owner = nullptr;
+        size_t _pass = 0;
+        _Stages _stage;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(*this);
+    }
+
+    Iter end() const noexcept {
+        return Iter();
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+private:
+    std::vector<T> _xs;
+    std::tuple<Passes...> _passes;
+};
+
+}
+
+inline constexpr _impl_vec::RemovalPass removal_pass;
+inline constexpr _impl_vec::ElemPass elem_pass;
+
+// a shrinker range over candidates of `passes` of `xs`, in order. See above.
+template<class T, class... Passes>
+requires (sizeof...(Passes) > 0)
+    && (std::invocable<const Passes&, const std::vector<T>&> && ...)
+auto vec_passes(std::vector<T> xs, Passes... passes) noexcept {
+    return _impl_vec::PassShrinker<T, Passes...>(std::move(xs), std::move(passes)...);
+}
+
+}
+
@@ -0,0 +1,174 @@
+#pragma once
+#include "core.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Minimization which builds candidates on a helper thread, while the
+// predicate runs on the calling thread, so constructing a candidate, e.g.,
+// copying a large vector, is off the critical path.
+//
+// The helper fills a ring of `depth` slots ahead of the predicate. Slots
+// keep their values across candidates and rounds, and a candidate is
+// materialized into the value of its slot if its iterator can, e.g., those
+// of vectors, so buffers are reused rather than allocated for every
+// candidate. An accepted candidate is swapped with the current value, whose
+// buffer goes back to the ring.
+//
+// Candidates are evaluated in order, and every round stops at the first
+// accepted one, so the result, and its decisions, are those of `minimize()`.
+// Candidates which the helper builds beyond an accepted one are dropped.
+// Checkpoints, hints and tracing are not supported.
+
+namespace shrink {
+
+struct PipelineOptions {
+    // the number of candidates built ahead of the predicate, at least 1.
+    size_t depth = 2;
+};
+
+namespace _impl_pipeline {
+
+template<class Iter, class T>
+void materialize(const Iter& it, std::optional<T>& out) noexcept {
+    if constexpr (requires(T& x) { it.materialize(x); }) {
+        if (out) {
+            it.materialize(*out);
+            return;
+        }
+    }
+    out.emplace(*it);
+}
+
+template<class T>
+struct Slot {
+    std::optional<T> value;
+    uint64_t round = 0;
+    uint64_t position = 0;
+    // no more candidates in the round.
+    bool end = false;
+};
+
+}
+
+template<Shrinkable T, class Pred>
+requires std::predicate<Pred&, const T&>
+Minimized<T> minimize_pipelined(
+    T init,
+    Pred pred,
+    const PipelineOptions& opts = {}) noexcept
+{
+    using namespace _impl_pipeline;
+    FASSERT(opts.depth > 0);
+    Minimized<T> res {
+        .value = std::move(init),
+    };
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::vector<Slot<T>> ring(opts.depth);
+    // Slots `[head, tail)` are built, and others are free.
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    uint64_t round = 0;
+    bool quit = false;
+
+    // The helper reads `res.value` only when it starts a round, which is
+    // before any candidate of the round is accepted.
+    auto build = [&]() noexcept {
+        for(uint64_t served = 0;;) {
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&]() { return quit || round != served; });
+                if (quit) {
+                    return;
+                }
+                served = round;
+            }
+            auto candidates = shrink(res.value);
+            auto it = candidates.begin();
+            auto end = candidates.end();
+            for(uint64_t position = 0;; ++position, ++it) {
+                uint64_t at = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mu);
+                    cv.wait(lock, [&]() {
+                        return quit || round != served || tail - head < ring.size();
+                    });
+                    if (quit || round != served) {
+                        break;
+                    }
+                    at = tail;
+                }
+                auto& slot = ring[at % ring.size()];
+                slot.round = served;
+                slot.position = position;
+                slot.end = it == end;
+                if (!slot.end) {
+                    materialize(it, slot.value);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mu);
+                    ++tail;
+                }
+                cv.notify_all();
+                if (slot.end) {
+                    break;
+                }
+            }
+        }
+    };
+
+    std::jthread helper(build);
+    for(bool accepted = true; accepted;) {
+        accepted = false;
+        uint64_t current = 0;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            current = ++round;
+        }
+        cv.notify_all();
+        for(;;) {
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&]() { return tail != head; });
+            }
+            auto& slot = ring[head % ring.size()];
+            bool stale = slot.round != current;
+            bool end = !stale && slot.end;
+            if (!stale && !end) {
+                ++res.stats.predicate_calls;
+                if (pred(std::as_const(*slot.value))) {
+                    ++res.stats.accepted;
+                    res.decisions.positions.push_back(slot.position);
+                    std::swap(res.value, *slot.value);
+                    accepted = true;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                ++head;
+            }
+            cv.notify_all();
+            if (accepted || end) {
+                break;
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        quit = true;
+    }
+    cv.notify_all();
+    return res;
+}
+
+}
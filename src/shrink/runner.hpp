@@ -0,0 +1,171 @@
+#pragma once
+#include "core.hpp"
+#include "minimize.hpp"
+#include "corpus.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace shrink {
+
+struct CheckOptions {
+    // The seed of the whole run. A random one is picked if absent.
+    std::optional<uint64_t> seed;
+    // Number of random cases.
+    size_t cases = 100;
+    // The size of the `i`-th case is `i % (max_size + 1)`.
+    size_t max_size = 100;
+    // Number of threads evaluating cases. 0 means the number of cores.
+    size_t threads = 0;
+    // If it is not empty,
+    // * entries of the corpus are replayed before any random case;
+    // * a minimized failure of a random case is appended to the corpus.
+    // It requires `Serializable<T>`.
+    std::filesystem::path corpus_path;
+    // options for minimizing the first failure.
+    MinimizeOptions minimize;
+};
+
+template<class T>
+struct CheckFailure {
+    // The failure is reproduced by `generate_case<T>(seed, case_index, max_size)`.
+    std::optional<size_t> case_index;
+    // Or else the failure is the entry of the corpus.
+    std::optional<size_t> corpus_index;
+    T original;
+    Minimized<T> minimized;
+};
+
+template<class T>
+struct CheckResult {
+    uint64_t seed = 0;
+    // number of random cases evaluated. Some cases after the failing one
+    // may be evaluated by other threads.
+    size_t cases_run = 0;
+    std::optional<CheckFailure<T>> failure;
+
+    explicit operator bool() const noexcept {
+        return !failure.has_value();
+    }
+};
+
+namespace _impl_runner {
+
+inline uint64_t splitmix64(uint64_t x) noexcept {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}
+
+// The `index`-th case of a run with `seed`.
+// It depends on nothing else, in particular not on the number of threads.
+template<Generatable T>
+T generate_case(uint64_t seed, size_t index, size_t max_size) noexcept {
+    Random rng(_impl_runner::splitmix64(seed ^ _impl_runner::splitmix64(index)));
+    return Generator<T>::generate(rng, index % (max_size + 1));
+}
+
+// Evaluates `prop`, which returns true iff the property holds, on
+// * every entry of the corpus, if `opts.corpus_path` is given, and then
+// * `opts.cases` random cases on `opts.threads` threads.
+// The failure with the smallest case index, regardless of the number of
+// threads, is minimized.
+// `prop` must be safe to call concurrently.
+template<class T, class Prop>
+requires Shrinkable<T> && Generatable<T> && std::predicate<Prop&, const T&>
+CheckResult<T> check(Prop prop, const CheckOptions& opts = {}) noexcept {
+    CheckResult<T> res;
+    res.seed = opts.seed ? *opts.seed : std::random_device()();
+    auto fails = [&](const T& x) noexcept {
+        return !prop(x);
+    };
+
+    if (!opts.corpus_path.empty()) {
+        if constexpr (Serializable<T>) {
+            auto corpus = Corpus::open(opts.corpus_path);
+            if (corpus) {
+                auto failure = replay_corpus<T>(*corpus, prop);
+                if (failure) {
+                    auto minimized = minimize(failure->value, fails, opts.minimize);
+                    res.failure = CheckFailure<T> {
+                        .corpus_index = failure->index,
+                        .original = std::move(failure->value),
+                        .minimized = std::move(minimized),
+                    };
+                    return res;
+                }
+            }
+        } else {
+            FASSERT(false);
+        }
+    }
+
+    constexpr size_t kNone = std::numeric_limits<size_t>::max();
+    std::atomic<size_t> next {0};
+    std::atomic<size_t> first_failure {kNone};
+    std::atomic<size_t> cases_run {0};
+    auto work = [&]() noexcept {
+        for(;;) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= opts.cases || i > first_failure.load(std::memory_order_relaxed)) {
+                return;
+            }
+            T x = generate_case<T>(res.seed, i, opts.max_size);
+            cases_run.fetch_add(1, std::memory_order_relaxed);
+            if (!prop(std::as_const(x))) {
+                size_t cur = first_failure.load(std::memory_order_relaxed);
+                while (i < cur
+                    && !first_failure.compare_exchange_weak(cur, i, std::memory_order_relaxed))
+                {}
+            }
+        }
+    };
+    size_t threads = opts.threads > 0
+        ? opts.threads
+        : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::min(threads, std::max<size_t>(opts.cases, 1));
+    {
+        std::vector<std::jthread> workers;
+        for(size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+    }
+    res.cases_run = cases_run.load();
+
+    size_t failed = first_failure.load();
+    if (failed == kNone) {
+        return res;
+    }
+    T original = generate_case<T>(res.seed, failed, opts.max_size);
+    auto minimized = minimize(original, fails, opts.minimize);
+    if constexpr (Serializable<T>) {
+        if (!opts.corpus_path.empty()) {
+            auto writer = CorpusWriter::open(opts.corpus_path);
+            if (writer) {
+                writer->append(minimized.value);
+            }
+        }
+    }
+    res.failure = CheckFailure<T> {
+        .case_index = failed,
+        .original = std::move(original),
+        .minimized = std::move(minimized),
+    };
+    return res;
+}
+
+}
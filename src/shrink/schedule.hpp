@@ -0,0 +1,209 @@
+#pragma once
+#include "core.hpp"
+#include "vec.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+// Adaptive scheduling of the passes of vector shrinking.
+//
+// `ChainShrinker` always tries every `LenShrinker` candidate before any
+// `ElemShrinker` one.
+// `minimize_adaptive()` rather splits candidates into arms, i.e., holes of a
+// size class (lengths in `[2^k, 2^(k+1))`) and element shrinking, tracks
+// how often candidates of every arm are accepted, and in every round
+// * tries arms in the order of `ChainShrinker` until they are warmed up,
+// * then tries warmed-up arms by an upper confidence bound of their
+//   acceptance rates,
+// * and defers arms which are hardly ever accepted: they are only tried when
+//   no other arm makes progress. So the result is as minimal as that of
+//   `minimize()`, i.e., no candidate of it fails.
+
+namespace shrink {
+
+struct ScheduleOptions {
+    // weight of exploration in the upper confidence bound.
+    double exploration = 0.5;
+    // Statistics of every arm decay by this factor on every trial of the arm,
+    // so recent trials weigh more.
+    double decay = 0.98;
+    // An arm is warmed up after this many (decayed) trials, and deferred ...
+    double defer_after = 16;
+    // ... if its acceptance rate is below this.
+    double defer_below = 0.02;
+};
+
+struct ArmStats {
+    // the arm is `LenShrinker` holes of lengths in `[2^k, 2^(k+1))` for
+    // `hole_class == k`, or `ElemShrinker` if `hole_class` is empty.
+    std::optional<size_t> hole_class;
+    size_t trials = 0;
+    size_t accepted = 0;
+};
+
+template<class T>
+struct AdaptiveMinimized {
+    T value;
+    MinimizeStats stats;
+    std::vector<ArmStats> arms;
+};
+
+namespace _impl_schedule {
+
+constexpr size_t kHoleClasses = 64;
+constexpr size_t kElemArm = kHoleClasses;
+constexpr size_t kArms = kHoleClasses + 1;
+
+inline size_t hole_class(size_t hole_len) noexcept {
+    return std::bit_width(hole_len) - 1;
+}
+
+struct Arm {
+    // decayed statistics, which drive the schedule.
+    double trials = 0;
+    double accepted = 0;
+    // plain statistics, which are reported.
+    size_t total_trials = 0;
+    size_t total_accepted = 0;
+
+    void record(bool accepted, double decay) noexcept {
+        trials = trials * decay + 1;
+        this->accepted = this->accepted * decay + (accepted ? 1 : 0);
+        ++total_trials;
+        if (accepted) {
+            ++total_accepted;
+        }
+    }
+
+    double rate() const noexcept {
+        return (accepted + 1) / (trials + 2);
+    }
+};
+
+}
+
+// Minimizes `init` like `minimize()`, but orders and defers passes
+// adaptively. See above.
+template<Shrinkable T, class Pred>
+requires std::predicate<Pred&, const std::vector<T>&>
+AdaptiveMinimized<std::vector<T>> minimize_adaptive(
+    std::vector<T> init,
+    Pred pred,
+    const ScheduleOptions& opts = {}) noexcept
+{
+    using namespace _impl_schedule;
+    std::vector<Arm> arms(kArms);
+    MinimizeStats stats;
+    std::vector<T> cur = std::move(init);
+
+    // tries candidates of `arm` of `cur`, and accepts the first failing one.
+    auto try_arm = [&](size_t arm) noexcept -> bool {
+        auto run = [&](const auto& shrinker, auto&& in_arm) noexcept -> bool {
+            for(auto it = shrinker.begin(), end = shrinker.end(); it != end; ++it) {
+                if (!in_arm(it)) {
+                    continue;
+                }
+                std::vector<T> cand = *it;
+                ++stats.predicate_calls;
+                bool accepted = pred(std::as_const(cand));
+                arms[arm].record(accepted, opts.decay);
+                if (accepted) {
+                    ++stats.accepted;
+                    cur = std::move(cand);
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (arm == kElemArm) {
+            _impl_vec::ElemShrinker<T> shrinker(cur);
+            return run(shrinker, [](const auto&) noexcept { return true; });
+        } else {
+            _impl_vec::LenShrinker<T> shrinker(cur);
+            return run(shrinker, [arm](const auto& it) noexcept {
+                return hole_class(it.hole().len) == arm;
+            });
+        }
+    };
+
+    // arms which have candidates for a vector of `n` elements, in the order
+    // of `ChainShrinker`.
+    auto live_arms = [](size_t n) noexcept {
+        std::vector<size_t> res;
+        if (n > 1) {
+            for(size_t k = hole_class(n / 2) + 1; k > 0; --k) {
+                res.push_back(k - 1);
+            }
+        }
+        if (n > 0) {
+            res.push_back(kElemArm);
+        }
+        return res;
+    };
+
+    for(;;) {
+        auto live = live_arms(cur.size());
+        double total = 0;
+        for(size_t a: live) {
+            total += arms[a].trials;
+        }
+        auto score = [&](size_t a) noexcept {
+            auto const& arm = arms[a];
+            return arm.rate()
+                + opts.exploration * std::sqrt(std::log(total + 1) / (arm.trials + 1));
+        };
+        std::vector<size_t> active;
+        std::vector<size_t> deferred;
+        for(size_t a: live) {
+            auto const& arm = arms[a];
+            if (arm.trials >= opts.defer_after
+                && arm.accepted / arm.trials < opts.defer_below)
+            {
+                deferred.push_back(a);
+            } else {
+                active.push_back(a);
+            }
+        }
+        // Arms are tried in the order of `ChainShrinker` until they are
+        // warmed up.
+        auto warm = std::stable_partition(active.begin(), active.end(), [&](size_t a) {
+            return arms[a].trials < opts.defer_after;
+        });
+        std::stable_sort(warm, active.end(), [&](size_t a, size_t b) {
+            return score(a) > score(b);
+        });
+        std::stable_sort(deferred.begin(), deferred.end(), [&](size_t a, size_t b) {
+            return score(a) > score(b);
+        });
+        bool progressed = std::ranges::any_of(active, try_arm)
+            || std::ranges::any_of(deferred, try_arm);
+        if (!progressed) {
+            break;
+        }
+    }
+
+    AdaptiveMinimized<std::vector<T>> res {
+        .value = std::move(cur),
+        .stats = stats,
+    };
+    for(size_t a = 0; a < kArms; ++a) {
+        if (arms[a].total_trials == 0) {
+            continue;
+        }
+        res.arms.push_back(ArmStats {
+            .hole_class = a == kElemArm ? std::nullopt : std::optional<size_t>(a),
+            .trials = arms[a].total_trials,
+            .accepted = arms[a].total_accepted,
+        });
+    }
+    return res;
+}
+
+}
@@ -0,0 +1,144 @@
+// The C++20 module `shrink`, which exports the public API of all.hpp, so
+// `import shrink;` replaces `#include "shrink/all.hpp"`.
+// It is built only with the CMake option `SHRINK_BUILD_MODULE`.
+//
+// Specializations of `Shrinker`, `Serializer` and `Generator` of all.hpp
+// come along with the primary templates. Names in `_impl_*` namespaces are
+// not exported.
+module;
+#include "shrink/all.hpp"
+export module shrink;
+
+export namespace shrink {
+
+// core.hpp
+using shrink::Shrinker;
+using shrink::Shrinkable;
+using shrink::shrink;
+using shrink::candidate_count;
+using shrink::candidate_table;
+using shrink::Serializer;
+using shrink::Serializable;
+using shrink::Random;
+using shrink::Generator;
+using shrink::Generatable;
+using shrink::Unshrink;
+using shrink::unshrink;
+
+// wide.hpp
+using shrink::WideInt;
+using shrink::WideInteger;
+
+// passes.hpp
+using shrink::removal_pass;
+using shrink::elem_pass;
+using shrink::vec_passes;
+
+// extents.hpp
+using shrink::ExtentsOptions;
+using shrink::Extent;
+using shrink::Extents;
+
+// text.hpp
+using shrink::TextBracket;
+using shrink::TextGrammar;
+using shrink::Text;
+using shrink::text;
+
+// minimize.hpp
+using shrink::MinimizeOptions;
+using shrink::MinimizeStats;
+using shrink::DecisionLog;
+using shrink::Minimized;
+using shrink::Checkpoint;
+using shrink::save_checkpoint;
+using shrink::load_checkpoint;
+using shrink::minimize;
+using shrink::replay;
+
+// corpus.hpp
+using shrink::CorpusView;
+using shrink::CorpusView_t;
+using shrink::CorpusWriter;
+using shrink::Corpus;
+using shrink::CorpusFailure;
+using shrink::replay_corpus;
+
+// runner.hpp
+using shrink::CheckOptions;
+using shrink::CheckFailure;
+using shrink::CheckResult;
+using shrink::generate_case;
+using shrink::check;
+
+// adaptor.hpp
+using shrink::filter_map;
+using shrink::filter;
+using shrink::prefilter;
+using shrink::map;
+
+// schedule.hpp
+using shrink::ScheduleOptions;
+using shrink::ArmStats;
+using shrink::AdaptiveMinimized;
+using shrink::minimize_adaptive;
+
+// partition.hpp
+using shrink::PartitionOptions;
+using shrink::PartitionMinimized;
+using shrink::minimize_partitioned;
+
+// block.hpp
+using shrink::BlockOptions;
+using shrink::BlockMinimized;
+using shrink::minimize_blocks;
+
+// cost.hpp
+using shrink::CostOptions;
+using shrink::CostMinimized;
+using shrink::minimize_cost;
+
+// coverage.hpp
+using shrink::CoverageOptions;
+using shrink::CoverageMinimized;
+using shrink::coverage_regions;
+using shrink::register_coverage_counters;
+using shrink::reset_coverage;
+using shrink::coverage_fingerprint;
+using shrink::minimize_coverage;
+
+// pipeline.hpp
+using shrink::PipelineOptions;
+using shrink::minimize_pipelined;
+
+// async.hpp
+using shrink::Task;
+using shrink::EventLoop;
+using shrink::AsyncOptions;
+using shrink::AsyncMinimized;
+using shrink::AsyncPredicate;
+using shrink::minimize_async;
+
+// coro.hpp
+using shrink::Yield;
+using shrink::coroutine_shrinker;
+
+// signature.hpp
+using shrink::Signature;
+using shrink::signature_of;
+using shrink::SignaturePredicate;
+using shrink::SignatureMinimized;
+using shrink::SignatureShrinker;
+
+// trace.hpp
+using shrink::TracePhase;
+using shrink::trace_phase_name;
+using shrink::trace_allocation_counter;
+using shrink::TraceMark;
+using shrink::TraceEvent;
+using shrink::TracePolicy;
+using shrink::NullTracer;
+using shrink::TraceSummaryRow;
+using shrink::RecordingTracer;
+
+}
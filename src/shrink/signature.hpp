@@ -0,0 +1,144 @@
+#pragma once
+#include "core.hpp"
+#include "minimize.hpp"
+#include "fassert.hpp"
+#include <concepts>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Minimization which keeps to one bug.
+//
+// A predicate returns the signature of the failure of a candidate, e.g., a
+// hash of the assertion site or of the stack, or nothing if the candidate
+// does not fail. A plain predicate accepts any failure, so minimization may
+// slip to a different, smaller bug. `SignatureShrinker` instead
+// * accepts only candidates which fail with the signature of the initial
+//   value, the target;
+// * keeps every other signature it meets as a further target, with the
+//   first value which fails so, to be minimized later by
+//   `minimize_slipped()`;
+// * memoizes results of the predicate by the serialized candidate, so
+//   minimizing further targets does not evaluate candidates again.
+//
+// The memo lives as long as the shrinker, and costs a serialized copy of
+// every candidate evaluated.
+
+namespace shrink {
+
+using Signature = uint64_t;
+
+// a signature of the failure at `site`, e.g., "file.cpp:42".
+inline Signature signature_of(std::string_view site) noexcept {
+    return _impl_minimize::digest(std::as_bytes(std::span(site)));
+}
+
+template<class Pred, class T>
+concept SignaturePredicate = std::invocable<Pred&, const T&>
+    && std::same_as<std::invoke_result_t<Pred&, const T&>, std::optional<Signature>>;
+
+template<class T>
+struct SignatureMinimized {
+    T value;
+    // the signature which `value` fails with, or nothing if the initial
+    // value does not fail at all.
+    std::optional<Signature> signature;
+    // `predicate_calls` counts candidates, including those whose results
+    // are memoized.
+    MinimizeStats stats;
+    // candidates whose results are memoized, so `pred` is not called.
+    size_t memo_hits = 0;
+};
+
+template<Shrinkable T, SignaturePredicate<T> Pred>
+requires Serializable<T>
+class SignatureShrinker {
+public:
+    explicit SignatureShrinker(Pred pred, MinimizeOptions opts = {}) noexcept
+    :   _pred(std::move(pred)),
+        _opts(std::move(opts))
+    {}
+
+    SignatureShrinker(const SignatureShrinker&) = delete;
+    SignatureShrinker& operator=(const SignatureShrinker&) = delete;
+
+    // minimizes `init` to a value which fails with the signature of `init`.
+    SignatureMinimized<T> minimize(T init) noexcept {
+        size_t hits = _memo_hits;
+        auto target = _evaluate(init);
+        SignatureMinimized<T> res {
+            .value = std::move(init),
+            .signature = target,
+        };
+        if (target) {
+            _slipped.erase(*target);
+            _minimized.insert(*target);
+            auto minimized = shrink::minimize(std::move(res.value), [&](const T& v) {
+                auto sig = _evaluate(v);
+                if (sig && *sig != *target && !_minimized.contains(*sig)) {
+                    _slipped.try_emplace(*sig, v);
+                }
+                return sig == target;
+            }, _opts);
+            res.value = std::move(minimized.value);
+            res.stats = minimized.stats;
+        }
+        ++res.stats.predicate_calls;
+        res.memo_hits = _memo_hits - hits;
+        return res;
+    }
+
+    // further targets met so far, which are not minimized yet, with the
+    // first values which fail so.
+    const std::map<Signature, T>& slipped() const noexcept {
+        return _slipped;
+    }
+
+    // minimizes the further target `sig`, or nothing if it is not one.
+    std::optional<SignatureMinimized<T>> minimize_slipped(Signature sig) noexcept {
+        auto it = _slipped.find(sig);
+        if (it == _slipped.end()) {
+            return std::nullopt;
+        }
+        T init = std::move(it->second);
+        _slipped.erase(it);
+        return minimize(std::move(init));
+    }
+
+    // number of distinct candidates which `pred` is called on.
+    size_t evaluations() const noexcept {
+        return _memo.size();
+    }
+
+private:
+    std::optional<Signature> _evaluate(const T& v) noexcept {
+        std::vector<std::byte> key;
+        Serializer<T>::write(key, v);
+        auto it = _memo.find(key);
+        if (it != _memo.end()) {
+            ++_memo_hits;
+            return it->second;
+        }
+        auto sig = _pred(v);
+        _memo.emplace(std::move(key), sig);
+        return sig;
+    }
+
+private:
+    Pred _pred;
+    MinimizeOptions _opts;
+    std::map<std::vector<std::byte>, std::optional<Signature>> _memo;
+    size_t _memo_hits = 0;
+    std::map<Signature, T> _slipped;
+    // targets which are minimized, or under minimization.
+    std::set<Signature> _minimized;
+};
+
+}
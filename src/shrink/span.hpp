@@ -1,41 +1,46 @@
 #pragma once
 
 #include "core.hpp"
-#include "fassert.hpp"
 #include <span>
 
 namespace shrink {
 
+// A span of a dynamic extent shrinks to its subspans, shorter ones first.
+// A span of a static extent has no candidates: its length is part of its
+// type, and it cannot shrink elements which it does not own.
+// `std::array` rather shrinks its elements. See array.hpp.
+
 namespace _impl_span {
 
 template<class T, size_t Extent>
+requires (Extent == std::dynamic_extent)
 struct ContiguousShrinker {
     struct Iter {
         using value_type = std::span<T, Extent>;
         using difference_type = std::ptrdiff_t;
 
-        Iter() noexcept
+        constexpr Iter() noexcept
         :   _state(std::nullopt)
         {}
 
-        explicit Iter(std::span<T, Extent> xs) noexcept
+        constexpr explicit Iter(std::span<T, Extent> xs) noexcept
         :   _state(_State(xs))
         {
             ++(*this);
         }
 
-        Iter(const Iter&) noexcept = default;
-        Iter& operator=(const Iter&) noexcept = default;
-        Iter(Iter&&) noexcept = default;
-        Iter& operator=(Iter&&) noexcept = default;
+        constexpr Iter(const Iter&) noexcept = default;
+        constexpr Iter& operator=(const Iter&) noexcept = default;
+        constexpr Iter(Iter&&) noexcept = default;
+        constexpr Iter& operator=(Iter&&) noexcept = default;
 
-        value_type operator*() const noexcept {
-            FASSERT(_state);
+        constexpr value_type operator*() const noexcept {
+            _impl_constexpr::expect(_state.has_value());
             return _state->span();
         }
 
-        Iter& operator++() noexcept {
-            FASSERT(_state);
+        constexpr Iter& operator++() noexcept {
+            _impl_constexpr::expect(_state.has_value());
             bool has_next = _state->next();
             if (!has_next) {
                 _state.reset();
@@ -43,16 +48,16 @@ struct ContiguousShrinker {
             return *this;
         }
 
-        Iter operator++(int) noexcept {
+        constexpr Iter operator++(int) noexcept {
             Iter copied(*this);
             ++(*this);
             return copied;
         }
 
-        bool operator==(const Iter& ano) const noexcept {
+        constexpr bool operator==(const Iter& ano) const noexcept {
             return _state == ano._state;
         }
-        bool operator!=(const Iter&) const noexcept = default;
+        constexpr bool operator!=(const Iter&) const noexcept = default;
 
     private:
         struct _State {
@@ -61,7 +66,7 @@ struct ContiguousShrinker {
             size_t count = 0;
             size_t count_complement = 0;
 
-            explicit _State(std::span<T, Extent> xs) noexcept
+            constexpr explicit _State(std::span<T, Extent> xs) noexcept
             :   elems(std::move(xs))
             {
                 count_complement = elems.size();
@@ -69,7 +74,7 @@ struct ContiguousShrinker {
                 offset = elems.size();
             }
 
-            bool operator==(const _State& ano) const noexcept {
+            constexpr bool operator==(const _State& ano) const noexcept {
                 if (elems.data() != ano.elems.data()) {
                     return false;
                 }
@@ -84,13 +89,13 @@ struct ContiguousShrinker {
                 }
                 return true;
             }
-            bool operator!=(const _State&) const noexcept = default;
+            constexpr bool operator!=(const _State&) const noexcept = default;
 
-            std::span<T> span() const noexcept {
+            constexpr std::span<T, Extent> span() const noexcept {
                 return elems.subspan(offset, count);
             }
 
-            bool next() noexcept {
+            constexpr bool next() noexcept {
                 ++offset;
                 if (offset + count <= elems.size()) {
                     return true;
@@ -110,45 +115,59 @@ struct ContiguousShrinker {
     using value_type = Iter::value_type;
     using difference_type = Iter::difference_type;
 
-    Iter begin() const noexcept {
+    constexpr Iter begin() const noexcept {
         return Iter(_xs);
     }
 
-    Iter end() const noexcept {
+    constexpr Iter end() const noexcept {
         return Iter();
     }
 
-    Iter cbegin() const noexcept {
+    constexpr Iter cbegin() const noexcept {
         return begin();
     }
 
-    Iter cend() const noexcept {
+    constexpr Iter cend() const noexcept {
         return end();
     }
 
-    explicit ContiguousShrinker(std::span<T, Extent> xs) noexcept
+    constexpr explicit ContiguousShrinker(std::span<T, Extent> xs) noexcept
     :   _xs(xs)
     {}
 
 private:
-    std::span<T> _xs;
+    std::span<T, Extent> _xs;
 };
 
 }
 
-template<class T, size_t Extent>
-struct Shrinker<std::span<T, Extent>> {
-    explicit Shrinker(std::span<T, Extent> xs) noexcept
+template<class T>
+struct Shrinker<std::span<T>> {
+    constexpr explicit Shrinker(std::span<T> xs) noexcept
     :   _xs(xs)
     {}
 
-    _impl_span::ContiguousShrinker<T, Extent> shrink() && noexcept {
-        return _impl_span::ContiguousShrinker<T, Extent>(std::move(_xs));
+    constexpr _impl_span::ContiguousShrinker<T, std::dynamic_extent> shrink() && noexcept {
+        return _impl_span::ContiguousShrinker<T, std::dynamic_extent>(std::move(_xs));
     }
 
 private:
-    std::span<T, Extent> _xs;
+    std::span<T> _xs;
+};
+
+template<class T, size_t Extent>
+requires (Extent != std::dynamic_extent)
+struct Shrinker<std::span<T, Extent>> {
+    constexpr explicit Shrinker(std::span<T, Extent>) noexcept
+    {}
+
+    constexpr _EmptyShrinkerImpl<std::span<T, Extent>> shrink() && noexcept {
+        return _EmptyShrinkerImpl<std::span<T, Extent>>();
+    }
 };
 
 }
 
+#ifdef SHRINK_EXTERN_TEMPLATES
+#include "instances.hpp"
+#endif
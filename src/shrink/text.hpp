@@ -0,0 +1,413 @@
+#pragma once
+#include "core.hpp"
+#include "fassert.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Shrinking of structured text, e.g., JSON, SQL and source code.
+//
+// Removing arbitrary byte ranges, as spans do, leaves almost every
+// candidate syntactically invalid, so the predicate runs only to reject it.
+// A `Text` rather shrinks by whole balanced regions, which a table of
+// delimiters, i.e., a `TextGrammar`, tells:
+// * elements between separators in a bracket pair, and statements between
+//   separators at top level, each with one adjacent separator, so
+//   `[1, 2, 3]` shrinks to `[ 2, 3]`, `[1, 3]` and `[1, 2]`;
+// * contents of bracket pairs, e.g., `{...}` shrinks to `{}`;
+// * contents of quoted strings, e.g., `"..."` shrinks to `""`;
+// * lines which close every bracket they open, if the grammar enables them.
+// Larger regions go first.
+//
+// The text is tokenized once per shrinker. Tokens are views into the text,
+// and a candidate is materialized only when it is dereferenced.
+// Tokenizing is lexical: brackets in comments are taken as brackets, and
+// mismatched closing brackets are ignored.
+
+namespace shrink {
+
+struct TextBracket {
+    char open;
+    char close;
+};
+
+struct TextGrammar {
+    std::vector<TextBracket> brackets;
+    // characters which open, and close, quoted strings.
+    std::string quotes;
+    // escapes the next character in a quoted string, or '\0' for none.
+    char escape = '\0';
+    // separators of elements in a bracket pair, and of statements at top
+    // level.
+    std::string separators;
+    // whether balanced lines are removed.
+    bool lines = false;
+
+    static TextGrammar json() {
+        return TextGrammar {
+            .brackets = {{'{', '}'}, {'[', ']'}},
+            .quotes = "\"",
+            .escape = '\\',
+            .separators = ",",
+        };
+    }
+
+    // A quote in an SQL string is escaped by doubling it, which splits the
+    // string into adjacent quoted strings, so it needs no escape character.
+    static TextGrammar sql() {
+        return TextGrammar {
+            .brackets = {{'(', ')'}},
+            .quotes = "'\"`",
+            .separators = ";,",
+            .lines = true,
+        };
+    }
+
+    // C and languages alike.
+    static TextGrammar c() {
+        return TextGrammar {
+            .brackets = {{'(', ')'}, {'[', ']'}, {'{', '}'}},
+            .quotes = "\"'",
+            .escape = '\\',
+            .separators = ";,",
+            .lines = true,
+        };
+    }
+};
+
+// Text which shrinks by its grammar. Candidates share the grammar.
+struct Text {
+    std::string str;
+    std::shared_ptr<const TextGrammar> grammar;
+
+    bool operator==(const Text& ano) const noexcept {
+        return str == ano.str;
+    }
+};
+
+inline Text text(std::string str, TextGrammar grammar) noexcept {
+    return Text {
+        .str = std::move(str),
+        .grammar = std::make_shared<const TextGrammar>(std::move(grammar)),
+    };
+}
+
+namespace _impl_text {
+
+struct Token {
+    enum class Kind: uint8_t {
+        kOpen,
+        kClose,
+        kQuoted,
+        kSeparator,
+        kNewline,
+    };
+
+    Kind kind;
+    std::string_view text;
+};
+
+// `[offset, offset + len)` of the text, which a candidate removes.
+struct Region {
+    size_t offset = 0;
+    size_t len = 0;
+
+    bool operator==(const Region&) const noexcept = default;
+};
+
+// Structural tokens of `str`, i.e., brackets, quoted strings, separators
+// and newlines. Other characters make no tokens.
+inline std::vector<Token> tokenize(std::string_view str, const TextGrammar& g) noexcept {
+    auto is_open = [&](char c) {
+        return std::ranges::any_of(g.brackets, [&](const TextBracket& b) { return b.open == c; });
+    };
+    auto is_close = [&](char c) {
+        return std::ranges::any_of(g.brackets, [&](const TextBracket& b) { return b.close == c; });
+    };
+    std::vector<Token> res;
+    for(size_t i = 0; i < str.size();) {
+        char c = str[i];
+        if (g.quotes.find(c) != std::string::npos) {
+            size_t j = i + 1;
+            for(; j < str.size() && str[j] != c; ++j) {
+                if (g.escape != '\0' && str[j] == g.escape) {
+                    ++j;
+                }
+            }
+            j = std::min(j + 1, str.size());
+            res.push_back(Token {Token::Kind::kQuoted, str.substr(i, j - i)});
+            i = j;
+            continue;
+        }
+        if (is_open(c)) {
+            res.push_back(Token {Token::Kind::kOpen, str.substr(i, 1)});
+        } else if (is_close(c)) {
+            res.push_back(Token {Token::Kind::kClose, str.substr(i, 1)});
+        } else if (g.separators.find(c) != std::string::npos) {
+            res.push_back(Token {Token::Kind::kSeparator, str.substr(i, 1)});
+        } else if (c == '\n') {
+            res.push_back(Token {Token::Kind::kNewline, str.substr(i, 1)});
+        }
+        ++i;
+    }
+    return res;
+}
+
+// Removable regions of `str`, larger ones first. See above.
+inline std::vector<Region> regions(std::string_view str, const TextGrammar& g) noexcept {
+    auto offset_of = [&](const Token& t) noexcept -> size_t {
+        return t.text.data() - str.data();
+    };
+    auto is_blank = [&](size_t from, size_t to) noexcept {
+        return std::ranges::all_of(str.substr(from, to - from), [](char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        });
+    };
+    std::vector<Region> res;
+    auto add = [&](size_t from, size_t to) noexcept {
+        if (from < to) {
+            res.push_back(Region {.offset = from, .len = to - from});
+        }
+    };
+
+    // bracket pairs being open, with the top level at the bottom.
+    struct Group {
+        char close = '\0';
+        // offset after the opening bracket.
+        size_t content = 0;
+        // where the current element starts.
+        size_t element = 0;
+        // the offset of the last separator, if any.
+        std::optional<size_t> separator;
+    };
+    std::vector<Group> groups = {Group {}};
+    // the offset where the current line starts, the depth there and the
+    // lowest depth since.
+    size_t line = 0;
+    size_t line_depth = 0;
+    size_t min_depth = 0;
+
+    // removes the last element of `grp` which ends at `end`, with the
+    // preceding separator if it is not the first one.
+    auto close_elements = [&](const Group& grp, size_t end) noexcept {
+        if (grp.separator && !is_blank(grp.element, end)) {
+            add(*grp.separator, end);
+        }
+    };
+    auto end_line = [&](size_t end) noexcept {
+        size_t depth = groups.size() - 1;
+        if (g.lines && depth == line_depth && min_depth >= line_depth && !is_blank(line, end)) {
+            add(line, end);
+        }
+        line = end;
+        line_depth = depth;
+        min_depth = depth;
+    };
+
+    for(const Token& t: tokenize(str, g)) {
+        size_t at = offset_of(t);
+        switch (t.kind) {
+        case Token::Kind::kQuoted:
+            if (t.text.size() >= 2 && t.text.back() == t.text.front()) {
+                add(at + 1, at + t.text.size() - 1);
+            }
+            break;
+        case Token::Kind::kOpen: {
+            auto b = std::ranges::find_if(g.brackets, [&](const TextBracket& b) {
+                return b.open == t.text.front();
+            });
+            FASSERT(b != g.brackets.end());
+            groups.push_back(Group {
+                .close = b->close,
+                .content = at + 1,
+                .element = at + 1,
+            });
+            break;
+        }
+        case Token::Kind::kClose:
+            if (groups.size() > 1 && groups.back().close == t.text.front()) {
+                close_elements(groups.back(), at);
+                add(groups.back().content, at);
+                groups.pop_back();
+                min_depth = std::min(min_depth, groups.size() - 1);
+            }
+            break;
+        case Token::Kind::kSeparator: {
+            auto& grp = groups.back();
+            if (!is_blank(grp.element, at)) {
+                add(grp.element, at + 1);
+            }
+            grp.element = at + 1;
+            grp.separator = at;
+            break;
+        }
+        case Token::Kind::kNewline:
+            end_line(at + 1);
+            break;
+        }
+    }
+    if (groups.size() == 1) {
+        close_elements(groups.front(), str.size());
+        end_line(str.size());
+    }
+
+    std::ranges::sort(res, [](const Region& a, const Region& b) {
+        if (a.len != b.len) {
+            return a.len > b.len;
+        }
+        return a.offset < b.offset;
+    });
+    // Removing `a` and a later `b` of the same length results in the same
+    // text iff the text from `a` to `b` repeats right after itself, e.g., a
+    // line and the statement which spans the same line but the newline
+    // before it. Such a region would waste a predicate call.
+    std::vector<Region> kept;
+    for(const Region& b: res) {
+        bool dup = false;
+        for(auto a = kept.rbegin(); a != kept.rend() && a->len == b.len; ++a) {
+            size_t gap = b.offset - a->offset;
+            if (str.substr(a->offset, gap) == str.substr(a->offset + a->len, gap)) {
+                dup = true;
+                break;
+            }
+        }
+        if (!dup) {
+            kept.push_back(b);
+        }
+    }
+    return kept;
+}
+
+struct TextShrinker {
+private:
+    struct _Data;
+
+public:
+    explicit TextShrinker(Text text) noexcept
+    :   _data(std::make_shared<_Data>(std::move(text)))
+    {}
+
+    struct Iter {
+        using value_type = Text;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        {}
+
+        value_type operator*() const noexcept {
+            FASSERT(_data != nullptr && _index < _data->regions.size());
+            const Text& t = _data->text;
+            const Region& r = _data->regions[_index];
+            Text res {
+                .grammar = t.grammar,
+            };
+            res.str.reserve(t.str.size() - r.len);
+            res.str.append(t.str, 0, r.offset);
+            res.str.append(t.str, r.offset + r.len);
+            return res;
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_data != nullptr);
+            ++_index;
+            if (_index >= _data->regions.size()) {
+                *this = Iter();
+            }
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        // the region which the current candidate removes.
+        Region region() const noexcept {
+            FASSERT(_data != nullptr);
+            return _data->regions[_index];
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _data == ano._data && _index == ano._index;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        friend struct TextShrinker;
+
+        // * `_data` is shared with the shrinker, so iterators survive it.
+        // * the end iterator has no data.
+        std::shared_ptr<const _Data> _data;
+        size_t _index = 0;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        if (_data->regions.empty()) {
+            return Iter();
+        }
+        Iter res;
+        res._data = _data;
+        return res;
+    }
+
+    Iter end() const noexcept {
+        return Iter();
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+private:
+    struct _Data {
+        explicit _Data(Text t) noexcept
+        :   text(std::move(t)),
+            regions(text.grammar ? _impl_text::regions(text.str, *text.grammar) : std::vector<Region>{})
+        {}
+
+        Text text;
+        std::vector<Region> regions;
+    };
+
+    std::shared_ptr<const _Data> _data;
+};
+
+}
+
+template<>
+struct Shrinker<Text> {
+    explicit Shrinker(Text t) noexcept
+    :   _t(std::move(t))
+    {}
+
+    _impl_text::TextShrinker shrink() && noexcept {
+        return _impl_text::TextShrinker(std::move(_t));
+    }
+
+private:
+    Text _t;
+};
+
+}
@@ -0,0 +1,327 @@
+#pragma once
+#include "fassert.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <map>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Tracing of shrink runs.
+//
+// `minimize()` takes a tracer as a compile-time policy.
+// * `NullTracer`, the default, disables tracing: every hook is discarded at
+//   compile time, so an untraced run costs nothing.
+// * `RecordingTracer` records every phase of every candidate, i.e.,
+//   - "step": stepping the iterator to the candidate (the first step of a
+//     round also covers creating the shrinker),
+//   - "construct": materializing the candidate,
+//   - "predicate": evaluating the predicate, with the size of the candidate
+//     and whether it is accepted,
+//   and every round. It exports them as Chrome trace JSON, which Perfetto
+//   and chrome://tracing open, and as a summary table with p50/p99
+//   latencies per phase and pass.
+//
+// Allocations are counted only if exactly one translation unit of the
+// program expands `SHRINK_TRACE_ALLOCATIONS()` at namespace scope, which
+// replaces the global `operator new`. Otherwise, counts are 0.
+
+namespace shrink {
+
+enum class TracePhase: uint8_t {
+    kRound,
+    kStep,
+    kConstruct,
+    kPredicate,
+};
+
+inline std::string_view trace_phase_name(TracePhase phase) noexcept {
+    switch (phase) {
+    case TracePhase::kRound:
+        return "round";
+    case TracePhase::kStep:
+        return "step";
+    case TracePhase::kConstruct:
+        return "construct";
+    case TracePhase::kPredicate:
+        return "predicate";
+    }
+    return "";
+}
+
+// number of allocations by the global `operator new` so far.
+inline std::atomic<uint64_t>& trace_allocation_counter() noexcept {
+    static std::atomic<uint64_t> counter {0};
+    return counter;
+}
+
+// a point in time, and the allocation count then.
+struct TraceMark {
+    uint64_t ns = 0;
+    uint64_t allocations = 0;
+
+    static TraceMark now() noexcept {
+        auto t = std::chrono::steady_clock::now().time_since_epoch();
+        return TraceMark {
+            .ns = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(t).count()),
+            .allocations = trace_allocation_counter().load(std::memory_order_relaxed),
+        };
+    }
+};
+
+struct TraceEvent {
+    TracePhase phase = TracePhase::kRound;
+    // the pass which the candidate comes from, e.g., "len" or "elem" of
+    // vectors, or "shrink" for shrinkers which tell no passes.
+    std::string_view pass;
+    // relative to the creation of the tracer.
+    uint64_t start_ns = 0;
+    uint64_t dur_ns = 0;
+    uint64_t allocations = 0;
+    // the size of the candidate, for "predicate" events.
+    size_t size = 0;
+    // whether the candidate, or any candidate of the round, is accepted.
+    bool accepted = false;
+};
+
+// A tracer records an event from `since` up to now, and returns now, so
+// successive phases can chain their marks.
+template<class T>
+concept TracePolicy = requires(
+    T& tracer,
+    TracePhase phase,
+    const TraceMark& since,
+    std::string_view pass,
+    size_t size,
+    bool accepted)
+{
+    { T::kEnabled } -> std::convertible_to<bool>;
+    { tracer.record(phase, since, pass, size, accepted) } noexcept
+        -> std::same_as<TraceMark>;
+};
+
+struct NullTracer {
+    static constexpr bool kEnabled = false;
+
+    TraceMark record(TracePhase, const TraceMark&, std::string_view, size_t, bool) noexcept {
+        return TraceMark {};
+    }
+};
+
+struct TraceSummaryRow {
+    TracePhase phase = TracePhase::kRound;
+    std::string_view pass;
+    size_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t allocations = 0;
+    size_t accepted = 0;
+};
+
+class RecordingTracer {
+public:
+    static constexpr bool kEnabled = true;
+
+    RecordingTracer() noexcept
+    :   _origin(TraceMark::now())
+    {}
+
+    TraceMark record(
+        TracePhase phase,
+        const TraceMark& since,
+        std::string_view pass,
+        size_t size,
+        bool accepted) noexcept
+    {
+        auto now = TraceMark::now();
+        _events.push_back(TraceEvent {
+            .phase = phase,
+            .pass = pass,
+            .start_ns = since.ns - _origin.ns,
+            .dur_ns = now.ns - since.ns,
+            .allocations = now.allocations - since.allocations,
+            .size = size,
+            .accepted = accepted,
+        });
+        // Recording itself is not charged to the next phase.
+        return TraceMark::now();
+    }
+
+    const std::vector<TraceEvent>& events() const noexcept {
+        return _events;
+    }
+
+    // Events in the Chrome trace event format, as complete ("X") events.
+    std::string chrome_trace() const noexcept {
+        std::string res = "{\"traceEvents\":[";
+        for(size_t i = 0; i < _events.size(); ++i) {
+            auto const& ev = _events[i];
+            if (i > 0) {
+                res += ',';
+            }
+            res += "{\"name\":\"";
+            res += trace_phase_name(ev.phase);
+            res += "\",\"cat\":\"";
+            _append_escaped(res, ev.pass);
+            res += "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":";
+            _append_us(res, ev.start_ns);
+            res += ",\"dur\":";
+            _append_us(res, ev.dur_ns);
+            res += ",\"args\":{\"allocations\":";
+            res += std::to_string(ev.allocations);
+            if (ev.phase == TracePhase::kPredicate) {
+                res += ",\"size\":";
+                res += std::to_string(ev.size);
+            }
+            if (ev.phase == TracePhase::kPredicate || ev.phase == TracePhase::kRound) {
+                res += ",\"accepted\":";
+                res += ev.accepted ? "true" : "false";
+            }
+            res += "}}";
+        }
+        res += "],\"displayTimeUnit\":\"ns\"}";
+        return res;
+    }
+
+    // statistics of events grouped by phase and pass.
+    std::vector<TraceSummaryRow> summary() const noexcept {
+        std::map<std::tuple<TracePhase, std::string_view>, std::vector<const TraceEvent*>> groups;
+        for(auto const& ev: _events) {
+            groups[{ev.phase, ev.pass}].push_back(&ev);
+        }
+        std::vector<TraceSummaryRow> res;
+        for(auto& [key, evs]: groups) {
+            TraceSummaryRow row {
+                .phase = std::get<0>(key),
+                .pass = std::get<1>(key),
+                .count = evs.size(),
+            };
+            std::vector<uint64_t> durs;
+            for(auto const* ev: evs) {
+                row.total_ns += ev->dur_ns;
+                row.allocations += ev->allocations;
+                row.accepted += ev->accepted;
+                durs.push_back(ev->dur_ns);
+            }
+            std::ranges::sort(durs);
+            row.p50_ns = _percentile(durs, 50);
+            row.p99_ns = _percentile(durs, 99);
+            res.push_back(row);
+        }
+        return res;
+    }
+
+    std::string summary_table() const noexcept {
+        std::string res;
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "%-10s %-8s %10s %12s %10s %10s %10s %9s\n",
+            "phase", "pass", "count", "total(us)", "p50(us)", "p99(us)", "allocs", "accepted");
+        res += buf;
+        for(auto const& row: summary()) {
+            std::string pass(row.pass);
+            std::snprintf(buf, sizeof(buf), "%-10s %-8s %10zu %12.1f %10.3f %10.3f %10llu %9zu\n",
+                std::string(trace_phase_name(row.phase)).c_str(),
+                pass.c_str(),
+                row.count,
+                row.total_ns / 1e3,
+                row.p50_ns / 1e3,
+                row.p99_ns / 1e3,
+                static_cast<unsigned long long>(row.allocations),
+                row.accepted);
+            res += buf;
+        }
+        return res;
+    }
+
+private:
+    // the nearest-rank percentile of sorted `xs`.
+    static uint64_t _percentile(const std::vector<uint64_t>& xs, size_t p) noexcept {
+        FASSERT(!xs.empty());
+        size_t rank = (xs.size() * p + 99) / 100;
+        return xs[std::max<size_t>(rank, 1) - 1];
+    }
+
+    static void _append_us(std::string& out, uint64_t ns) noexcept {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%llu.%03llu",
+            static_cast<unsigned long long>(ns / 1000),
+            static_cast<unsigned long long>(ns % 1000));
+        out += buf;
+    }
+
+    static void _append_escaped(std::string& out, std::string_view xs) noexcept {
+        for(char c: xs) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+    }
+
+private:
+    TraceMark _origin;
+    std::vector<TraceEvent> _events;
+};
+
+namespace _impl_trace {
+
+// the pass of the current candidate of `it`, if it tells.
+template<class Iter>
+std::string_view pass_of(const Iter& it) noexcept {
+    if constexpr (requires { { it.pass_name() } -> std::convertible_to<std::string_view>; }) {
+        return it.pass_name();
+    } else {
+        return "shrink";
+    }
+}
+
+template<class T>
+size_t size_of(const T& v) noexcept {
+    if constexpr (std::ranges::sized_range<const T>) {
+        return std::ranges::size(v);
+    } else {
+        return 1;
+    }
+}
+
+}
+
+}
+
+// The replacements are not inlined, or GCC takes them as mismatched
+// allocation and deallocation.
+#define SHRINK_TRACE_ALLOCATIONS() \
+    [[gnu::noinline]] void* operator new(std::size_t n) { \
+        ::shrink::trace_allocation_counter().fetch_add(1, std::memory_order_relaxed); \
+        if (void* p = std::malloc(n == 0 ? 1 : n)) { \
+            return p; \
+        } \
+        throw std::bad_alloc(); \
+    } \
+    [[gnu::noinline]] void* operator new[](std::size_t n) { \
+        return ::operator new(n); \
+    } \
+    [[gnu::noinline]] void operator delete(void* p) noexcept { \
+        std::free(p); \
+    } \
+    [[gnu::noinline]] void operator delete[](void* p) noexcept { \
+        std::free(p); \
+    } \
+    [[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { \
+        std::free(p); \
+    } \
+    [[gnu::noinline]] void operator delete[](void* p, std::size_t) noexcept { \
+        std::free(p); \
+    }
@@ -2,13 +2,59 @@
 #include "core.hpp"
 #include "fassert.hpp"
 #include <memory>
+#include <optional>
+#include <ranges>
+#include <string_view>
 #include <vector>
 #include <type_traits>
+#include <random>
+#include <cstdint>
+#include <cstring>
 
 namespace shrink {
 
 namespace _impl_vec {
 
+// `len` consecutive elements from `offset`, which a `LenShrinker` candidate
+// removes.
+struct Hole {
+    size_t offset = 0;
+    size_t len = 0;
+
+    bool operator==(const Hole&) const noexcept = default;
+};
+
+// The position of a candidate in `ChainShrinker`: a hole of `LenShrinker`,
+// or an element of `ElemShrinker`.
+// It also serves as a hint where to continue shrinking a vector after a
+// candidate is accepted. See `Shrinker<std::vector<T>>::shrink(const Position&)`.
+struct Position {
+    enum class Pass: uint8_t {
+        kLen,
+        kElem,
+    };
+
+    Pass pass = Pass::kLen;
+    Hole hole;
+    size_t index = 0;
+
+    bool operator==(const Position&) const noexcept = default;
+
+    // the order of candidates in `ChainShrinker`: larger holes go first.
+    bool operator<(const Position& ano) const noexcept {
+        if (pass != ano.pass) {
+            return pass < ano.pass;
+        }
+        if (pass == Pass::kElem) {
+            return index < ano.index;
+        }
+        if (hole.len != ano.hole.len) {
+            return hole.len > ano.hole.len;
+        }
+        return hole.offset < ano.hole.offset;
+    }
+};
+
 template<class T>
 requires std::is_move_constructible_v<T> && std::is_copy_constructible_v<T>
 struct LenShrinker {
@@ -31,11 +77,26 @@ struct LenShrinker {
             ++(*this);
         }
 
+        // starts from the first hole which is not before `start`.
+        explicit Iter(const std::vector<T>& xs, Hole start) noexcept
+        :   _state(_State(xs, start))
+        {
+            if (!_state->valid()) {
+                _state.reset();
+            }
+        }
+
         value_type operator*() const noexcept {
             FASSERT(_state);
             return **_state;
         }
 
+        // materializes the current candidate into `out`, reusing its buffer.
+        void materialize(value_type& out) const noexcept {
+            FASSERT(_state);
+            _state->materialize(out);
+        }
+
         Iter& operator++() noexcept {
             FASSERT(_state);
             bool has_next = _state->next();
@@ -45,6 +106,12 @@ struct LenShrinker {
             return *this;
         }
 
+        // the hole of the current candidate, known without materializing it.
+        Hole hole() const noexcept {
+            FASSERT(_state);
+            return _state->hole();
+        }
+
         Iter operator++(int) noexcept {
             Iter copied(*this);
             ++(*this);
@@ -64,6 +131,28 @@ struct LenShrinker {
                 _hole_len(vs.size())
             {}
 
+            // Hole lengths are `size / 2^k`, and offsets are multiples of the
+            // length, so `start` is rounded to the first hole not before it.
+            explicit _State(const std::vector<T>& vs, Hole start) noexcept
+            :   _elems(&vs),
+                _hole_len(vs.size() / 2)
+            {
+                while (_hole_len > start.len) {
+                    _hole_len /= 2;
+                }
+                if (_hole_len > 0 && _hole_len == start.len) {
+                    _hole_offset = start.offset / _hole_len * _hole_len;
+                    if (_hole_offset >= _elems->size()) {
+                        _hole_len /= 2;
+                        _hole_offset = 0;
+                    }
+                }
+            }
+
+            bool valid() const noexcept {
+                return _hole_len > 0;
+            }
+
             bool next() noexcept {
                 _hole_offset += _hole_len;
                 if (_hole_offset >= _elems->size()) {
@@ -73,19 +162,31 @@ struct LenShrinker {
                 return _hole_len > 0;
             }
 
+            Hole hole() const noexcept {
+                return Hole {
+                    .offset = _hole_offset,
+                    .len = _hole_len,
+                };
+            }
+
             std::vector<T> operator*() const noexcept {
                 std::vector<T> res;
-                res.insert(
-                    res.end(),
+                materialize(res);
+                return res;
+            }
+
+            void materialize(std::vector<T>& out) const noexcept {
+                out.clear();
+                out.insert(
+                    out.end(),
                     _elems->begin(),
                     _elems->begin() + _hole_offset);
                 if (_hole_offset + _hole_len < _elems->size()) {
-                    res.insert(
-                        res.end(),
+                    out.insert(
+                        out.end(),
                         _elems->begin() + _hole_offset + _hole_len,
                         _elems->end());
                 }
-                return res;
             }
 
             bool operator==(const _State& ano) const noexcept {
@@ -145,6 +246,32 @@ private:
     const std::vector<T>* _elems = nullptr;
 };
 
+template<Shrinkable T>
+struct ChainShrinker;
+
+// How `ElemShrinker` shrinks an element:
+// * an element which is a vector is borrowed from the enclosing vector, so
+//   nested vectors are never copied before their candidates are
+//   materialized;
+// * any other element is copied into its shrinker.
+template<class T>
+struct ElemShrinking {
+    using type = std::invoke_result_t<decltype(shrink<T>), T>;
+
+    static type make(const T& x) noexcept {
+        return shrink(x);
+    }
+};
+
+template<class U>
+struct ElemShrinking<std::vector<U>> {
+    using type = ChainShrinker<U>;
+
+    static type make(const std::vector<U>& xs) noexcept {
+        return ChainShrinker<U>::borrow(xs);
+    }
+};
+
 template<class T>
 requires
     std::is_move_constructible_v<T>
@@ -170,11 +297,25 @@ struct ElemShrinker {
             ++(*this);
         }
 
+        // starts from the first element, not before the `start`-th one,
+        // which has candidates.
+        explicit Iter(const std::vector<T>& xs, size_t start) noexcept
+        :   _state(_State(xs, start))
+        {
+            ++(*this);
+        }
+
         value_type operator*() const noexcept {
             FASSERT(_state);
             return **_state;
         }
 
+        // materializes the current candidate into `out`, reusing its buffer.
+        void materialize(value_type& out) const noexcept {
+            FASSERT(_state);
+            _state->materialize(out);
+        }
+
         Iter& operator++() noexcept {
             FASSERT(_state);
             bool has_next = _state->next();
@@ -184,6 +325,13 @@ struct ElemShrinker {
             return *this;
         }
 
+        // the index of the element which the current candidate shrinks, known
+        // without materializing it.
+        size_t index() const noexcept {
+            FASSERT(_state);
+            return _state->index();
+        }
+
         Iter operator++(int) noexcept {
             Iter copied(*this);
             ++(*this);
@@ -202,6 +350,11 @@ struct ElemShrinker {
             :   _elems(&xs)
             {}
 
+            explicit _State(const std::vector<T>& xs, size_t start) noexcept
+            :   _elems(&xs),
+                _index(static_cast<int64_t>(start) - 1)
+            {}
+
             std::vector<T> operator*() const noexcept {
                 FASSERT(!_elem_iters.empty());
                 std::vector<T> res;
@@ -214,6 +367,16 @@ struct ElemShrinker {
                 return res;
             }
 
+            void materialize(std::vector<T>& out) const noexcept {
+                FASSERT(!_elem_iters.empty());
+                out.assign(_elems->begin(), _elems->end());
+                out[_index] = *std::get<0>(_elem_iters);
+            }
+
+            size_t index() const noexcept {
+                return _index;
+            }
+
             bool next() noexcept {
                 if (!_elem_iters.empty()) {
                     _elem_iters = std::move(_elem_iters).next();
@@ -221,7 +384,8 @@ struct ElemShrinker {
                 if (_elem_iters.empty()) {
                     ++_index;
                     for(int64_t n = _elems->size(); _index < n; ++_index) {
-                        _shrinker.reset(new ElemShrinkerType(shrink((*_elems)[_index])));
+                        _shrinker.reset(new ElemShrinkerType(
+                            ElemShrinking<T>::make((*_elems)[_index])));
                         _elem_iters = std::move(
                             std::ranges::subrange(_shrinker->begin(), _shrinker->end()));
                         if (!_elem_iters.empty()) {
@@ -255,7 +419,7 @@ struct ElemShrinker {
             bool operator!=(const _State&) const noexcept = default;
 
         private:
-            using ElemShrinkerType = std::invoke_result_t<decltype(shrink<T>), T>;
+            using ElemShrinkerType = typename ElemShrinking<T>::type;
             using ElemShrinkerIter = typename ElemShrinkerType::const_iterator;
 
             const std::vector<T>* _elems = nullptr;
@@ -304,12 +468,34 @@ private:
     const std::vector<T>* _elems = nullptr;
 };
 
+// A `ChainShrinker` either owns its vector, or borrows one which outlives it,
+// e.g., an element of the vector of an enclosing shrinker.
+// It is move-only, so the vector is never copied behind the scenes.
+// Like other shrinkers, iterators must not outlive it, nor survive moving it.
 template<Shrinkable T>
 struct ChainShrinker {
     explicit ChainShrinker(std::vector<T> vs) noexcept
-    :   _elems(std::move(vs))
+    :   _owned(std::move(vs))
+    {}
+
+    // Candidates start from the first one not before `start`, and wrap around
+    // to the first candidate until they reach `start` again.
+    explicit ChainShrinker(std::vector<T> vs, const Position& start) noexcept
+    :   _owned(std::move(vs)),
+        _start(start)
     {}
 
+    static ChainShrinker borrow(const std::vector<T>& vs) noexcept {
+        ChainShrinker res(std::vector<T>{});
+        res._borrowed = &vs;
+        return res;
+    }
+
+    ChainShrinker(const ChainShrinker&) = delete;
+    ChainShrinker& operator=(const ChainShrinker&) = delete;
+    ChainShrinker(ChainShrinker&&) noexcept = default;
+    ChainShrinker& operator=(ChainShrinker&&) noexcept = default;
+
     struct Iter {
         using value_type = std::vector<T>;
         using difference_type = std::ptrdiff_t;
@@ -322,14 +508,40 @@ struct ChainShrinker {
         Iter() noexcept
         {}
 
+        // `ElemShrinker` starts only when `LenShrinker` runs out, because
+        // starting it shrinks the first element, and a greedy step usually
+        // accepts a removal before.
         explicit Iter(const std::vector<T>& xs) noexcept
+        :   _xs(&xs)
         {
             LenShrinker<T> len_sh(xs);
             _len_shrinker = std::move(
                 std::ranges::subrange<LenIter>(len_sh.begin(), len_sh.end()));
-            ElemShrinker<T> elem_sh(xs);
-            _elem_shrinker = std::move(
-                std::ranges::subrange<ElemIter>(elem_sh.begin(), elem_sh.end()));
+            if (_len_shrinker.empty()) {
+                _start_elem();
+            }
+        }
+
+        explicit Iter(const std::vector<T>& xs, const Position& start) noexcept
+        :   _xs(&xs)
+        {
+            if (start.pass == Position::Pass::kLen) {
+                _len_shrinker = std::ranges::subrange<LenIter>(
+                    LenIter(xs, start.hole), LenIter());
+                if (_len_shrinker.empty()) {
+                    _start_elem();
+                }
+            } else {
+                _elem_shrinker = std::ranges::subrange<ElemIter>(
+                    ElemIter(xs, start.index), ElemIter());
+            }
+            if (_len_shrinker.empty() && _elem_shrinker.empty()) {
+                // nothing from `start` on, so it is a plain iterator from the
+                // first candidate.
+                *this = Iter(xs);
+                return;
+            }
+            _stop = position();
         }
 
         value_type operator*() const noexcept {
@@ -340,13 +552,29 @@ struct ChainShrinker {
             return _elem_shrinker.front();
         }
 
+        // materializes the current candidate into `out`, reusing its buffer.
+        void materialize(value_type& out) const noexcept {
+            if (!_len_shrinker.empty()) {
+                _len_shrinker.begin().materialize(out);
+                return;
+            }
+            FASSERT(!_elem_shrinker.empty());
+            _elem_shrinker.begin().materialize(out);
+        }
+
         Iter& operator++() noexcept {
             if (!_len_shrinker.empty()) {
                 _len_shrinker = std::move(_len_shrinker).next();
-                return *this;
+                if (_len_shrinker.empty()) {
+                    _start_elem();
+                }
+            } else {
+                FASSERT(!_elem_shrinker.empty());
+                _elem_shrinker = std::move(_elem_shrinker).next();
+            }
+            if (_stop) {
+                _wrap_around();
             }
-            FASSERT(!_elem_shrinker.empty());
-            _elem_shrinker = std::move(_elem_shrinker).next();
             return *this;
         }
 
@@ -356,6 +584,43 @@ struct ChainShrinker {
             return copied;
         }
 
+        // the hole of the current candidate if it comes from `LenShrinker`.
+        std::optional<Hole> hole() const noexcept {
+            if (!_len_shrinker.empty()) {
+                return _len_shrinker.begin().hole();
+            }
+            return std::nullopt;
+        }
+
+        // the index of the shrunk element if the current candidate comes from
+        // `ElemShrinker`.
+        std::optional<size_t> index() const noexcept {
+            if (_len_shrinker.empty() && !_elem_shrinker.empty()) {
+                return _elem_shrinker.begin().index();
+            }
+            return std::nullopt;
+        }
+
+        // the position of the current candidate.
+        Position position() const noexcept {
+            if (!_len_shrinker.empty()) {
+                return Position {
+                    .pass = Position::Pass::kLen,
+                    .hole = _len_shrinker.begin().hole(),
+                };
+            }
+            FASSERT(!_elem_shrinker.empty());
+            return Position {
+                .pass = Position::Pass::kElem,
+                .index = _elem_shrinker.begin().index(),
+            };
+        }
+
+        // the pass of the current candidate, for tracing.
+        std::string_view pass_name() const noexcept {
+            return _len_shrinker.empty() ? "elem" : "len";
+        }
+
         bool operator==(const Iter& ano) const noexcept {
             if (_len_shrinker.begin() != ano._len_shrinker.begin()) {
                 return false;
@@ -368,12 +633,43 @@ struct ChainShrinker {
 
         bool operator!=(const Iter& ano) const noexcept = default;
 
+    private:
+        void _start_elem() noexcept {
+            _elem_shrinker = std::ranges::subrange<ElemIter>(
+                ElemIter(*_xs), ElemIter());
+        }
+
+        // * restarts from the first candidate when candidates from the start
+        //   position run out;
+        // * and then stops at the start position.
+        void _wrap_around() noexcept {
+            if (!_wrapped && _len_shrinker.empty() && _elem_shrinker.empty()) {
+                _wrapped = true;
+                auto stop = _stop;
+                *this = Iter(*_xs);
+                _stop = stop;
+                _wrapped = true;
+            }
+            if (_wrapped
+                && !(_len_shrinker.empty() && _elem_shrinker.empty())
+                && !(position() < *_stop))
+            {
+                _len_shrinker = {};
+                _elem_shrinker = {};
+            }
+        }
+
     private:
         using LenIter = typename LenShrinker<T>::const_iterator;
         std::ranges::subrange<LenIter> _len_shrinker;
 
         using ElemIter = typename ElemShrinker<T>::const_iterator;
         std::ranges::subrange<ElemIter> _elem_shrinker;
+
+        const std::vector<T>* _xs = nullptr;
+        // for candidates from a start position.
+        std::optional<Position> _stop;
+        bool _wrapped = false;
     };
 
     using iterator = Iter;
@@ -382,7 +678,10 @@ struct ChainShrinker {
     using difference_type = Iter::difference_type;
 
     Iter begin() const noexcept {
-        return Iter(_elems);
+        if (_start) {
+            return Iter(_elems(), *_start);
+        }
+        return Iter(_elems());
     }
 
     Iter end() const noexcept {
@@ -398,7 +697,14 @@ struct ChainShrinker {
     }
 
 private:
-    const std::vector<T> _elems;
+    const std::vector<T>& _elems() const noexcept {
+        return _borrowed != nullptr ? *_borrowed : _owned;
+    }
+
+private:
+    std::vector<T> _owned;
+    const std::vector<T>* _borrowed = nullptr;
+    std::optional<Position> _start;
 };
 
 }
@@ -409,12 +715,122 @@ struct Shrinker<std::vector<T>> {
     :   _xs(std::move(xs))
     {}
 
+    using Hint = _impl_vec::Position;
+
     _impl_vec::ChainShrinker<T> shrink() && noexcept {
-        return _impl_vec::ChainShrinker<T>(_xs);
+        return _impl_vec::ChainShrinker<T>(std::move(_xs));
+    }
+
+    // shrinks from `hint`, usually the position of the last accepted
+    // candidate, and wraps around. So a sweep over a long vector does not
+    // retry every hole and element before `hint` after each acceptance.
+    _impl_vec::ChainShrinker<T> shrink(const Hint& hint) && noexcept {
+        return _impl_vec::ChainShrinker<T>(std::move(_xs), hint);
     }
 
 private:
     std::vector<T> _xs;
 };
 
+template<>
+struct Serializer<_impl_vec::Position> {
+    static void write(std::vector<std::byte>& out, const _impl_vec::Position& x) noexcept {
+        _impl_serde::write_raw(out, static_cast<uint8_t>(x.pass));
+        _impl_serde::write_raw(out, static_cast<uint64_t>(x.hole.offset));
+        _impl_serde::write_raw(out, static_cast<uint64_t>(x.hole.len));
+        _impl_serde::write_raw(out, static_cast<uint64_t>(x.index));
+    }
+
+    static std::optional<_impl_vec::Position> read(std::span<const std::byte>& in) noexcept {
+        auto pass = _impl_serde::read_raw<uint8_t>(in);
+        auto offset = _impl_serde::read_raw<uint64_t>(in);
+        auto len = _impl_serde::read_raw<uint64_t>(in);
+        auto index = _impl_serde::read_raw<uint64_t>(in);
+        if (!pass || !offset || !len || !index) {
+            return std::nullopt;
+        }
+        return _impl_vec::Position {
+            .pass = static_cast<_impl_vec::Position::Pass>(*pass),
+            .hole = _impl_vec::Hole {
+                .offset = *offset,
+                .len = *len,
+            },
+            .index = *index,
+        };
+    }
+};
+
+template<Generatable T>
+struct Generator<std::vector<T>> {
+    static std::vector<T> generate(Random& rng, size_t size) noexcept {
+        size_t n = std::uniform_int_distribution<size_t>(0, size)(rng);
+        std::vector<T> res;
+        res.reserve(n);
+        for(size_t i = 0; i < n; ++i) {
+            res.push_back(Generator<T>::generate(rng, size));
+        }
+        return res;
+    }
+};
+
+template<Serializable T>
+struct Serializer<std::vector<T>> {
+    static void write(std::vector<std::byte>& out, const std::vector<T>& xs) noexcept {
+        _impl_serde::write_raw(out, static_cast<uint64_t>(xs.size()));
+        if constexpr (_is_raw_copyable) {
+            auto const* p = reinterpret_cast<const std::byte*>(xs.data());
+            out.insert(out.end(), p, p + xs.size() * sizeof(T));
+        } else {
+            for(const T& x: xs) {
+                Serializer<T>::write(out, x);
+            }
+        }
+    }
+
+    static std::optional<std::vector<T>> read(std::span<const std::byte>& in) noexcept {
+        auto n = _impl_serde::read_raw<uint64_t>(in);
+        if (!n) {
+            return std::nullopt;
+        }
+        std::vector<T> res;
+        if constexpr (_is_raw_copyable) {
+            if (in.size() / sizeof(T) < *n) {
+                return std::nullopt;
+            }
+            res.resize(*n);
+            std::memcpy(res.data(), in.data(), *n * sizeof(T));
+            in = in.subspan(*n * sizeof(T));
+        } else {
+            for(uint64_t i = 0; i < *n; ++i) {
+                auto x = Serializer<T>::read(in);
+                if (!x) {
+                    return std::nullopt;
+                }
+                res.push_back(std::move(*x));
+            }
+        }
+        return res;
+    }
+
+private:
+    // * Elements of arithmetic types are encoded as their raw bytes, so they
+    //   can be copied in bulk.
+    // * vector<bool> is packed, so it has no contiguous storage of `bool`.
+    static constexpr bool _is_raw_copyable =
+        (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        || std::is_same_v<T, std::byte>;
+};
+
 }
+
+// `LenShrinker` and `ElemShrinker` own nothing, so their iterators work
+// without them.
+template<class T>
+inline constexpr bool std::ranges::enable_borrowed_range<shrink::_impl_vec::LenShrinker<T>> = true;
+
+template<class T>
+inline constexpr bool std::ranges::enable_borrowed_range<shrink::_impl_vec::ElemShrinker<T>> = true;
+
+#ifdef SHRINK_EXTERN_TEMPLATES
+#include "instances.hpp"
+#endif
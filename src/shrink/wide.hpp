@@ -0,0 +1,390 @@
+#pragma once
+#include "core.hpp"
+#include "fassert.hpp"
+#include <array>
+#include <bit>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// Shrinkers of integers wider than 64 bits.
+//
+// A type is a wide integer if `WideInt<T>` is specialized for it, as it is
+// for `int128_t` and `uint128_t`:
+//
+//     template<>
+//     struct WideInt<T> {
+//         static constexpr size_t kWords = ...;
+//         static constexpr bool kSigned = ...;
+//         // two's complement, the least significant word first.
+//         static std::array<uint64_t, kWords> to_words(const T&) noexcept;
+//         static T from_words(const std::array<uint64_t, kWords>&) noexcept;
+//     };
+//
+// Like the shrinker of integral types, a wide integer shrinks towards 0 and
+// keeps its sign. Candidates of a value, whose magnitude is `v`, are
+// * 0;
+// * `v` with one nonzero word cleared, from the most significant word;
+// * `v` with one word `w` replaced, from the most significant word, by
+//   `w >> s` for `s` halving from the largest shift keeping `w` nonzero, and
+//   then by `w - (w >> k)` for `k` in 1, 2, 3, ... for the most significant
+//   nonzero word, or in 1, 2, 4, ... for other words.
+// So only the most significant nonzero word has O(bits) candidates, others
+// have O(log(bits)), and clearing whole words first makes a value converge
+// in a few predicate calls when only its high words matter.
+// The price is that, unlike integral types, the result is not necessarily
+// the smallest failing integer, e.g., of a threshold, but one whose most
+// significant word is.
+
+namespace shrink {
+
+template<class T>
+struct WideInt;
+
+// In GNU modes, where `std::is_integral_v<int128_t>` holds, 128-bit integers
+// are shrunk as integral types.
+template<class T>
+concept WideInteger = std::is_copy_constructible_v<T>
+    && !std::is_integral_v<T>
+    && requires(const T& v, const std::array<uint64_t, WideInt<T>::kWords>& ws) {
+        { WideInt<T>::kSigned } -> std::convertible_to<bool>;
+        { WideInt<T>::to_words(v) } noexcept
+            -> std::same_as<std::array<uint64_t, WideInt<T>::kWords>>;
+        { WideInt<T>::from_words(ws) } noexcept -> std::same_as<T>;
+    };
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+template<class T>
+requires std::is_same_v<T, int128_t> || std::is_same_v<T, uint128_t>
+struct WideInt<T> {
+    static constexpr size_t kWords = 2;
+    static constexpr bool kSigned = std::is_same_v<T, int128_t>;
+
+    static std::array<uint64_t, 2> to_words(const T& v) noexcept {
+        auto u = static_cast<uint128_t>(v);
+        return {static_cast<uint64_t>(u), static_cast<uint64_t>(u >> 64)};
+    }
+
+    static T from_words(const std::array<uint64_t, 2>& ws) noexcept {
+        return static_cast<T>((static_cast<uint128_t>(ws[1]) << 64) | ws[0]);
+    }
+};
+#endif
+
+namespace _impl_wide {
+
+template<size_t N>
+using Words = std::array<uint64_t, N>;
+
+template<size_t N>
+Words<N> negate(Words<N> ws) noexcept {
+    uint64_t carry = 1;
+    for(size_t i = 0; i < N; ++i) {
+        ws[i] = ~ws[i] + carry;
+        carry = carry & (ws[i] == 0);
+    }
+    return ws;
+}
+
+template<size_t N>
+size_t nonzero_words(const Words<N>& ws) noexcept {
+    size_t res = 0;
+    for(uint64_t w: ws) {
+        res += (w != 0);
+    }
+    return res;
+}
+
+template<WideInteger T>
+struct Shrinker {
+    static constexpr size_t N = WideInt<T>::kWords;
+
+    struct Iter {
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iter(const Iter&) noexcept = default;
+        Iter& operator=(const Iter&) noexcept = default;
+        Iter(Iter&&) noexcept = default;
+        Iter& operator=(Iter&&) noexcept = default;
+
+        Iter() noexcept
+        :   _state(std::nullopt)
+        {}
+
+        explicit Iter(const T& v) noexcept
+        :   _state(_State(v))
+        {
+            if (!_state->valid() && !_state->next()) {
+                _state.reset();
+            }
+        }
+
+        T operator*() const noexcept {
+            FASSERT(_state);
+            return **_state;
+        }
+
+        Iter& operator++() noexcept {
+            FASSERT(_state);
+            bool has_next = _state->next();
+            if (!has_next) {
+                _state.reset();
+            }
+            return *this;
+        }
+
+        Iter operator++(int) noexcept {
+            Iter copied(*this);
+            ++(*this);
+            return copied;
+        }
+
+        bool operator==(const Iter& ano) const noexcept {
+            return _state == ano._state;
+        }
+
+        bool operator!=(const Iter&) const noexcept = default;
+
+    private:
+        enum class Phase: uint8_t {
+            kZero,
+            kClear,
+            kShift,
+            kHalve,
+            kDone,
+        };
+
+        struct _State {
+            Words<N> magnitude {};
+            bool negative = false;
+            Phase phase = Phase::kZero;
+            // the word which the current candidate changes, from `N - 1`
+            // down to 0.
+            size_t word = N - 1;
+            // the shift of the current candidate.
+            unsigned shift = 0;
+
+            explicit _State(const T& v) noexcept
+            {
+                auto ws = WideInt<T>::to_words(v);
+                negative = WideInt<T>::kSigned && (ws[N - 1] >> 63) != 0;
+                magnitude = negative ? negate(ws) : ws;
+            }
+
+            T operator*() const noexcept {
+                auto ws = magnitude;
+                uint64_t w = ws[word];
+                switch (phase) {
+                case Phase::kZero:
+                    ws = Words<N> {};
+                    break;
+                case Phase::kClear:
+                    ws[word] = 0;
+                    break;
+                case Phase::kShift:
+                    ws[word] = w >> shift;
+                    break;
+                case Phase::kHalve:
+                    ws[word] = w - (w >> shift);
+                    break;
+                case Phase::kDone:
+                    FASSERT(false);
+                }
+                return WideInt<T>::from_words(negative ? negate(ws) : ws);
+            }
+
+            // whether the current position is a candidate.
+            bool valid() const noexcept {
+                uint64_t w = magnitude[word];
+                switch (phase) {
+                case Phase::kZero:
+                    return nonzero_words(magnitude) > 0;
+                case Phase::kClear:
+                    return w != 0 && nonzero_words(magnitude) > 1;
+                case Phase::kShift:
+                    return shift >= 2 && shift < 64 && (w >> shift) != 0;
+                case Phase::kHalve:
+                    return shift < 64 && (w >> shift) != 0;
+                case Phase::kDone:
+                    return true;
+                }
+                return false;
+            }
+
+            // steps to the next candidate.
+            bool next() noexcept {
+                do {
+                    _step();
+                } while (!valid());
+                return phase != Phase::kDone;
+            }
+
+            bool operator==(const _State& ano) const noexcept {
+                return magnitude == ano.magnitude
+                    && negative == ano.negative
+                    && phase == ano.phase
+                    && word == ano.word
+                    && shift == ano.shift;
+            }
+
+            bool operator!=(const _State&) const noexcept = default;
+
+        private:
+            void _step() noexcept {
+                switch (phase) {
+                case Phase::kZero:
+                    phase = Phase::kClear;
+                    word = N - 1;
+                    return;
+                case Phase::kClear:
+                    if (word > 0) {
+                        --word;
+                        return;
+                    }
+                    phase = Phase::kShift;
+                    word = N - 1;
+                    shift = _top_shift(word);
+                    return;
+                case Phase::kShift:
+                    if (shift / 2 >= 2) {
+                        shift /= 2;
+                        return;
+                    }
+                    phase = Phase::kHalve;
+                    shift = 1;
+                    return;
+                case Phase::kHalve:
+                    if (unsigned k = _next_halving(); k < 64 && (magnitude[word] >> k) != 0) {
+                        shift = k;
+                        return;
+                    }
+                    if (word > 0) {
+                        --word;
+                        phase = Phase::kShift;
+                        shift = _top_shift(word);
+                        return;
+                    }
+                    phase = Phase::kDone;
+                    return;
+                case Phase::kDone:
+                    return;
+                }
+            }
+
+            // The most significant nonzero word halves bit by bit, so its
+            // magnitude converges exactly; other words halve by doubling
+            // shifts.
+            unsigned _next_halving() const noexcept {
+                bool top = true;
+                for(size_t i = word + 1; i < N; ++i) {
+                    top = top && magnitude[i] == 0;
+                }
+                return top ? shift + 1 : shift * 2;
+            }
+
+            // the largest shift which keeps the word nonzero, or 0 if the word
+            // is 0.
+            unsigned _top_shift(size_t i) const noexcept {
+                unsigned width = std::bit_width(magnitude[i]);
+                return width - (width > 0);
+            }
+        };
+
+        std::optional<_State> _state;
+    };
+
+    using iterator = Iter;
+    using const_iterator = Iter;
+    using value_type = Iter::value_type;
+    using difference_type = Iter::difference_type;
+
+    Iter begin() const noexcept {
+        return Iter(_v);
+    }
+
+    Iter end() const noexcept {
+        return Iter();
+    }
+
+    Iter cbegin() const noexcept {
+        return begin();
+    }
+
+    Iter cend() const noexcept {
+        return end();
+    }
+
+    explicit Shrinker(T v) noexcept
+    :   _v(std::move(v))
+    {}
+
+private:
+    T _v;
+};
+
+}
+
+template<WideInteger T>
+struct Shrinker<T> {
+    explicit Shrinker(T v) noexcept
+    :   _v(std::move(v))
+    {}
+
+    _impl_wide::Shrinker<T> shrink() && noexcept {
+        _impl_wide::Shrinker<T> x(std::move(_v));
+        return x;
+    }
+
+private:
+    T _v;
+};
+
+template<WideInteger T>
+struct Serializer<T> {
+    static void write(std::vector<std::byte>& out, const T& v) noexcept {
+        for(uint64_t w: WideInt<T>::to_words(v)) {
+            _impl_serde::write_raw(out, w);
+        }
+    }
+
+    static std::optional<T> read(std::span<const std::byte>& in) noexcept {
+        _impl_wide::Words<WideInt<T>::kWords> ws;
+        for(uint64_t& w: ws) {
+            auto x = _impl_serde::read_raw<uint64_t>(in);
+            if (!x) {
+                return std::nullopt;
+            }
+            w = *x;
+        }
+        return WideInt<T>::from_words(ws);
+    }
+};
+
+template<WideInteger T>
+struct Generator<T> {
+    // Like integral types, most values are in `[-size, size]`, and values
+    // of all words random come out now and then.
+    static T generate(Random& rng, size_t size) noexcept {
+        constexpr size_t N = WideInt<T>::kWords;
+        _impl_wide::Words<N> ws {};
+        if (std::uniform_int_distribution<int>(0, 3)(rng) == 0) {
+            for(uint64_t& w: ws) {
+                w = rng();
+            }
+            return WideInt<T>::from_words(ws);
+        }
+        ws[0] = std::uniform_int_distribution<uint64_t>(0, size)(rng);
+        if (WideInt<T>::kSigned && std::bernoulli_distribution()(rng)) {
+            ws = _impl_wide::negate(ws);
+        }
+        return WideInt<T>::from_words(ws);
+    }
+};
+
+}
@@ -0,0 +1,136 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/adaptor.hpp"
+#include "shrink/minimize.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <optional>
+#include <ranges>
+#include <iterator>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+template<class R>
+string format_vecs(const R& trial) {
+    vector<string> res;
+    ranges::copy(
+        trial | views::transform([](auto const& xs) {
+            return format("[{}]", join(xs, ", "sv));
+        }),
+        back_inserter(res));
+    return join(res, " "sv);
+}
+
+void shrink_filter(const string&) {
+    vector<uint8_t> xs = {1, 2};
+    auto trial = shrink::filter(
+        shrink::shrink(xs),
+        [](const vector<uint8_t>& xs) { return ranges::is_sorted(xs); });
+    auto trial_str = format_vecs(trial);
+    auto oracle_str = "[2] [1] [0, 2] [1, 1]"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_filter);
+
+namespace {
+void shrink_prefilter(const string&) {
+    vector<uint8_t> xs = {1, 2};
+    size_t materialized = 0;
+    auto trial = shrink::prefilter(
+        shrink::map(
+            shrink::shrink(xs),
+            [&](vector<uint8_t> xs) {
+                ++materialized;
+                return xs;
+            }),
+        [](const auto& it) {
+            auto index = it.base().index();
+            return !index || *index != 0;
+        });
+    auto trial_str = format_vecs(trial);
+    auto oracle_str = "[2] [1] [1, 0] [1, 1]"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+    TESTA_ASSERT(materialized == 4)
+        .hint("materialized: {}", materialized)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_prefilter);
+
+namespace {
+void shrink_filter_map(const string&) {
+    uint8_t x = 10;
+    auto trial = shrink::filter_map(
+        shrink::shrink(x),
+        [](uint8_t x) -> optional<uint8_t> {
+            if (x % 2 != 0) {
+                return nullopt;
+            }
+            return x / 2;
+        });
+    vector<uint8_t> trial_res;
+    ranges::copy(trial, back_inserter(trial_res));
+    vector<uint8_t> oracle = {0, 4};
+    TESTA_ASSERT(trial_res == oracle)
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_filter_map);
+
+namespace {
+struct Sorted {
+    vector<int> xs;
+};
+}
+
+template<>
+struct shrink::Shrinker<Sorted> {
+    explicit Shrinker(Sorted v) noexcept
+    :   _v(std::move(v))
+    {}
+
+    auto shrink() && noexcept {
+        return shrink::map(
+            shrink::filter(
+                shrink::shrink(std::move(_v.xs)),
+                [](const vector<int>& xs) { return ranges::is_sorted(xs); }),
+            [](vector<int> xs) { return Sorted {.xs = std::move(xs)}; });
+    }
+
+private:
+    Sorted _v;
+};
+
+namespace {
+void minimize_sorted(const string&) {
+    Sorted init {.xs = {1, 3, 7, 60, 61, 99}};
+    bool all_sorted = true;
+    auto trial = shrink::minimize(init, [&](const Sorted& v) {
+        all_sorted = all_sorted && ranges::is_sorted(v.xs);
+        return v.xs.size() >= 2 && v.xs.back() >= 50;
+    });
+    vector<int> oracle = {0, 50};
+    TESTA_ASSERT(trial.value.xs == oracle)
+        .hint("trial: {}", join(trial.value.xs, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+    TESTA_ASSERT(all_sorted)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_sorted);
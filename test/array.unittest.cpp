@@ -0,0 +1,59 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/span.hpp"
+#include "shrink/array.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+void shrink_array(const string&) {
+    array<uint8_t, 3> xs = {2, 0, 1};
+    auto trial = shrink::shrink(xs);
+    string trial_str = [&]() {
+        vector<string> res;
+        ranges::copy(
+            trial
+            | views::transform([](auto const& xs) {
+                return format("[{}]", join(xs, ", "sv));
+            }),
+            back_inserter(res));
+        return join(res, ", "sv);
+    }();
+    auto oracle_str = "[0, 0, 1], [1, 0, 1], [2, 0, 0]"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_array);
+
+namespace {
+void shrink_array_empty(const string&) {
+    auto trial = shrink::shrink(array<int, 0> {});
+    TESTA_ASSERT(trial.begin() == trial.end())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_array_empty);
+
+namespace {
+void shrink_static_span(const string&) {
+    array<uint8_t, 4> xs = {1, 2, 3, 4};
+    auto trial = shrink::shrink(span<uint8_t, 4>(xs));
+    static_assert(is_same_v<ranges::range_value_t<decltype(trial)>, span<uint8_t, 4>>);
+    TESTA_ASSERT(trial.begin() == trial.end())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_static_span);
@@ -0,0 +1,162 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/async.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+bool fails(const vector<int>& xs) {
+    return ranges::any_of(xs, [](int x) { return x >= 50; });
+}
+
+const vector<int> kInput = {3, 14, 15, 92, 65, 35};
+
+void minimize_async_in_order(const string&) {
+    shrink::EventLoop loop;
+    // Candidates complete out of order: shorter ones take longer.
+    auto trial = shrink::minimize_async(
+        kInput,
+        [&](const vector<int>& xs) -> shrink::Task<bool> {
+            co_await loop.sleep_for(chrono::microseconds(100 * (8 - xs.size())));
+            co_return fails(xs);
+        },
+        loop,
+        shrink::AsyncOptions {.in_flight = 4});
+    auto oracle = shrink::minimize(kInput, fails);
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.stats.accepted == oracle.stats.accepted)
+        .hint("trial: {}", trial.stats.accepted)
+        .hint("oracle: {}", oracle.stats.accepted)
+        .issue();
+    TESTA_ASSERT(trial.cancelled > 0)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_async_in_order);
+
+namespace {
+void minimize_async_timeout(const string&) {
+    shrink::EventLoop loop;
+    size_t stopped = 0;
+    // Candidates with 92 never respond in time, so they are rejected.
+    auto trial = shrink::minimize_async(
+        kInput,
+        [&](const vector<int>& xs, stop_token stop) -> shrink::Task<bool> {
+            if (ranges::find(xs, 92) != xs.end()) {
+                co_await loop.sleep_for(chrono::milliseconds(20));
+                stopped += stop.stop_requested();
+            }
+            co_return fails(xs);
+        },
+        loop,
+        shrink::AsyncOptions {
+            .in_flight = 2,
+            .timeout = chrono::milliseconds(2),
+        });
+    auto oracle = shrink::minimize(kInput, [](const vector<int>& xs) {
+        return ranges::find(xs, 92) == xs.end() && fails(xs);
+    });
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    // Some are cancelled rather than timed out.
+    TESTA_ASSERT(trial.timed_out > 0 && stopped >= trial.timed_out)
+        .hint("timed out: {}", trial.timed_out)
+        .hint("stopped: {}", stopped)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_async_timeout);
+
+namespace {
+// a stand-in server which responds on its own thread.
+class Server {
+public:
+    explicit Server(shrink::EventLoop& loop)
+    :   _loop(loop),
+        _worker([this](stop_token stop) { _serve(stop); })
+    {}
+
+    // an awaitable which resumes on the loop after the server responds.
+    auto request() {
+        struct Awaiter {
+            Server* server;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(coroutine_handle<> h) {
+                {
+                    lock_guard<mutex> lock(server->_mu);
+                    server->_requests.push_back(h);
+                }
+                server->_cv.notify_one();
+            }
+
+            void await_resume() noexcept {}
+        };
+        return Awaiter {.server = this};
+    }
+
+private:
+    void _serve(stop_token stop) {
+        unique_lock<mutex> lock(_mu);
+        while (!stop.stop_requested()) {
+            _cv.wait(lock, stop, [&]() { return !_requests.empty(); });
+            while (!_requests.empty()) {
+                auto h = _requests.front();
+                _requests.pop_front();
+                lock.unlock();
+                this_thread::sleep_for(chrono::microseconds(200));
+                _loop.post(h);
+                lock.lock();
+            }
+        }
+    }
+
+private:
+    shrink::EventLoop& _loop;
+    mutex _mu;
+    condition_variable_any _cv;
+    deque<coroutine_handle<>> _requests;
+    jthread _worker;
+};
+
+void minimize_async_server(const string&) {
+    shrink::EventLoop loop;
+    Server server(loop);
+    auto trial = shrink::minimize_async(
+        kInput,
+        [&](const vector<int>& xs) -> shrink::Task<bool> {
+            co_await server.request();
+            co_return fails(xs);
+        },
+        loop);
+    auto oracle = shrink::minimize(kInput, fails);
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_async_server);
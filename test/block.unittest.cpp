@@ -0,0 +1,58 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/block.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+void minimize_blocks(const string&) {
+    // Counters which all become 0 but one.
+    vector<int> xs(200, 5);
+    auto pred = [](const vector<int>& xs) {
+        return xs.size() == 200 && xs[123] >= 3;
+    };
+    auto oracle = shrink::minimize(xs, pred);
+    auto trial = shrink::minimize_blocks(xs, pred);
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls < oracle.stats.predicate_calls / 10)
+        .hint("trial: {}", trial.stats.predicate_calls)
+        .hint("oracle: {}", oracle.stats.predicate_calls)
+        .issue();
+    TESTA_ASSERT(trial.block_accepted > 0)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_blocks);
+
+namespace {
+void minimize_blocks_by_value(const string&) {
+    vector<int> xs;
+    for(int i = 0; i < 100; ++i) {
+        xs.push_back(i % 2 == 0 ? 7 : 9);
+    }
+    auto pred = [](const vector<int>& xs) {
+        return xs.size() == 100 && xs[1] == 9;
+    };
+    auto trial = shrink::minimize_blocks(xs, pred, shrink::BlockOptions {.min_block = 100});
+    vector<int> oracle(100, 0);
+    oracle[1] = 9;
+    TESTA_ASSERT(trial.value == oracle)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.value_accepted == 1 && trial.block_accepted == 0)
+        .hint("value_accepted: {}", trial.value_accepted)
+        .hint("block_accepted: {}", trial.block_accepted)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_blocks_by_value);
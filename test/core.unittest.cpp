@@ -23,3 +23,13 @@ void shrink_unshrink(const string&) {
 }
 }
 TESTA_DEF_JUNIT_LIKE1(shrink_unshrink);
+
+namespace {
+void candidate_table_unshrink(const string&) {
+    static constexpr auto kTable = shrink::candidate_table<shrink::unshrink(10)>();
+    static_assert(kTable.empty());
+    TESTA_ASSERT(shrink::candidate_count(shrink::unshrink(10)) == kTable.size())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(candidate_table_unshrink);
@@ -0,0 +1,111 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/coro.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+struct Point {
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const Point&) const noexcept = default;
+};
+
+string to_string(const Point& p) {
+    return format("({}, {})", p.x, p.y);
+}
+}
+
+template<>
+struct shrink::Shrinker<Point> {
+    explicit Shrinker(Point p) noexcept
+    :   _p(p)
+    {}
+
+    auto shrink() && noexcept {
+        return shrink::coroutine_shrinker([p = _p]() -> shrink::Yield<Point> {
+            for(int x: shrink::shrink(p.x)) {
+                co_yield Point {.x = x, .y = p.y};
+            }
+            for(int y: shrink::shrink(p.y)) {
+                co_yield Point {.x = p.x, .y = y};
+            }
+        });
+    }
+
+private:
+    Point _p;
+};
+
+static_assert(shrink::Shrinkable<Point>);
+
+namespace {
+void shrink_coroutine(const string&) {
+    auto trial = shrink::shrink(Point {.x = 4, .y = 2});
+    vector<string> res;
+    for(auto const& p: trial) {
+        res.push_back(to_string(p));
+    }
+    string trial_str = join(res, ", "sv);
+    auto oracle_str = "(0, 2), (2, 2), (3, 2), (4, 0), (4, 1)"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_coroutine);
+
+namespace {
+void shrink_coroutine_multipass(const string&) {
+    auto trial = shrink::shrink(Point {.x = 4, .y = 2});
+    auto it = trial.begin();
+    ++it;
+    auto copied = it;
+    // Both step on, from the same position.
+    ++it;
+    ++copied;
+    TESTA_ASSERT(it == copied && *it == *copied)
+        .hint("it: {}", to_string(*it))
+        .hint("copied: {}", to_string(*copied))
+        .issue();
+    TESTA_ASSERT(ranges::distance(trial) == 5)
+        .issue();
+    TESTA_ASSERT(ranges::distance(trial) == ranges::distance(trial.begin(), trial.end()))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_coroutine_multipass);
+
+namespace {
+void shrink_coroutine_empty(const string&) {
+    auto trial = shrink::shrink(Point {});
+    TESTA_ASSERT(trial.begin() == trial.end())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_coroutine_empty);
+
+namespace {
+void minimize_coroutine(const string&) {
+    auto trial = shrink::minimize(Point {.x = 97, .y = 31}, [](const Point& p) {
+        return p.x + p.y >= 50;
+    });
+    Point oracle {.x = 19, .y = 31};
+    TESTA_ASSERT(trial.value == oracle)
+        .hint("trial: {}", to_string(trial.value))
+        .hint("oracle: {}", to_string(oracle))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_coroutine);
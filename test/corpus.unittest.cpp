@@ -0,0 +1,90 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/corpus.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <span>
+#include <filesystem>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+void corpus_replay_in_place(const string& case_name) {
+    auto path = filesystem::temp_directory_path() / format("{}.corpus", case_name);
+    filesystem::remove(path);
+    {
+        auto writer = shrink::CorpusWriter::open(path);
+        TESTA_ASSERT(writer.has_value())
+            .issue();
+        writer->append(vector<int>{1, 2});
+        writer->append(vector<int>{});
+        writer->append(vector<int>{3, 50, 4});
+    }
+    auto corpus = shrink::Corpus::open(path);
+    TESTA_ASSERT(corpus.has_value())
+        .issue();
+    TESTA_ASSERT(corpus->size() == 3)
+        .hint("size: {}", corpus->size())
+        .issue();
+    vector<string> trial_res;
+    auto failure = shrink::replay_corpus<vector<int>>(
+        *corpus,
+        [&](span<const int> xs) {
+            trial_res.push_back(format("[{}]", join(xs, ", "sv)));
+            return ranges::all_of(xs, [](int x) { return x < 50; });
+        });
+    filesystem::remove(path);
+    auto trial_str = join(trial_res, " "sv);
+    auto oracle_str = "[1, 2] [] [3, 50, 4]"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+    TESTA_ASSERT(failure.has_value() && failure->index == 2)
+        .issue();
+    vector<int> oracle = {3, 50, 4};
+    TESTA_ASSERT(failure->value == oracle)
+        .hint("trial: {}", join(failure->value, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(corpus_replay_in_place);
+
+namespace {
+void corpus_replay_deserialized(const string& case_name) {
+    auto path = filesystem::temp_directory_path() / format("{}.corpus", case_name);
+    filesystem::remove(path);
+    {
+        auto writer = shrink::CorpusWriter::open(path);
+        writer->append(vector<bool>{true, false});
+    }
+    {
+        // appends to the existing corpus.
+        auto writer = shrink::CorpusWriter::open(path);
+        writer->append(vector<bool>{true, true, true});
+    }
+    auto corpus = shrink::Corpus::open(path);
+    vector<size_t> trial_res;
+    auto failure = shrink::replay_corpus<vector<bool>>(
+        *corpus,
+        [&](const vector<bool>& xs) {
+            trial_res.push_back(xs.size());
+            return true;
+        });
+    filesystem::remove(path);
+    vector<size_t> oracle = {2, 3};
+    TESTA_ASSERT(trial_res == oracle)
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+    TESTA_ASSERT(!failure.has_value())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(corpus_replay_deserialized);
@@ -0,0 +1,100 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/cost.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+// a clock which predicates advance by their simulated runtimes.
+struct FakeClock {
+    using rep = int64_t;
+    using period = nano;
+    using duration = chrono::nanoseconds;
+    using time_point = chrono::time_point<FakeClock>;
+    static constexpr bool is_steady = true;
+
+    static inline duration elapsed {0};
+
+    static time_point now() noexcept {
+        return time_point(elapsed);
+    }
+};
+
+// fails iff 5 is there, in 1 ms per element, except vectors shorter than 3,
+// which take a slow path of 100 ms.
+bool slow_when_tiny(const vector<int>& xs) {
+    FakeClock::elapsed += xs.size() < 3
+        ? chrono::milliseconds(100)
+        : chrono::milliseconds(xs.size());
+    return ranges::find(xs, 5) != xs.end();
+}
+
+void minimize_cost_avoids_slow_path(const string&) {
+    vector<int> xs = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto oracle = shrink::minimize(xs, slow_when_tiny);
+    TESTA_ASSERT(oracle.value == vector<int> {5})
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+
+    auto trial = shrink::minimize_cost<FakeClock>(xs, slow_when_tiny);
+    TESTA_ASSERT(trial.value.size() == 3 && ranges::count(trial.value, 0) == 2)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.runtimes.front() == chrono::milliseconds(8)
+            && trial.runtimes.back() == chrono::milliseconds(3)
+            && trial.runtimes.size() == trial.stats.accepted + 1)
+        .hint("runtimes: {}", trial.runtimes.size())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_cost_avoids_slow_path);
+
+namespace {
+void minimize_cost_prefers_cheap(const string&) {
+    // fails iff 5 is there, in 50 ms if it goes first, or in 2 ms otherwise.
+    auto pred = [](const vector<int>& xs) {
+        FakeClock::elapsed += !xs.empty() && xs.front() == 5
+            ? chrono::milliseconds(50)
+            : chrono::milliseconds(2);
+        return ranges::find(xs, 5) != xs.end();
+    };
+    vector<int> xs = {9, 5, 1};
+    auto oracle = shrink::minimize(xs, pred);
+    TESTA_ASSERT(oracle.value == vector<int> {5})
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+
+    // Within a loose budget, the first failing candidate, i.e., [5, 1], is
+    // passed over for the cheaper [9, 5].
+    auto loose = shrink::minimize_cost<FakeClock>(
+        xs,
+        pred,
+        shrink::CostOptions {.max_slowdown = 100});
+    vector<chrono::nanoseconds> expected_runtimes = {
+        chrono::milliseconds(2),
+        chrono::milliseconds(2),
+        chrono::milliseconds(2),
+        chrono::milliseconds(50),
+    };
+    TESTA_ASSERT(loose.value == oracle.value && loose.runtimes == expected_runtimes)
+        .hint("loose: {}", join(loose.value, ", "sv))
+        .issue();
+
+    // Within the default budget, [5] is too slow.
+    auto trial = shrink::minimize_cost<FakeClock>(xs, pred);
+    vector<int> expected = {0, 5};
+    TESTA_ASSERT(trial.value == expected)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_cost_prefers_cheap);
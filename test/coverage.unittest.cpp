@@ -0,0 +1,102 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/coverage.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+// counters of a subject which the tests instrument by hand.
+uint8_t counters[4];
+
+// sums `xs`, but wrongly if any element is above 100.
+int64_t subject(const vector<int>& xs) {
+    static bool registered = (shrink::register_coverage_counters(begin(counters), end(counters)), true);
+    (void) registered;
+    int64_t sum = 0;
+    for(int x: xs) {
+        ++counters[0];
+        if (x > 100) {
+            ++counters[1];
+            sum += x / 2;
+        } else {
+            ++counters[2];
+            sum += x;
+        }
+    }
+    return sum;
+}
+
+// the slow differential check.
+struct Oracle {
+    size_t* calls;
+
+    bool operator()(const vector<int>& xs) const {
+        ++*calls;
+        int64_t sum = 0;
+        for(int x: xs) {
+            sum += x;
+        }
+        return subject(xs) != sum;
+    }
+};
+
+vector<int> input() {
+    return {3, 1, 4, 1, 150, 9, 2, 6};
+}
+
+void minimize_coverage_memo(const string&) {
+    size_t oracle_calls = 0;
+    auto oracle = shrink::minimize(input(), Oracle {&oracle_calls});
+
+    size_t trial_calls = 0;
+    auto trial = shrink::minimize_coverage(
+        input(),
+        subject,
+        Oracle {&trial_calls},
+        shrink::CoverageOptions {.hit_counts = false});
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial_calls == trial.stats.predicate_calls
+            && trial_calls < oracle_calls
+            && trial.memo_hits > 0)
+        .hint("trial: {}", trial_calls)
+        .hint("oracle: {}", oracle_calls)
+        .hint("memo hits: {}", trial.memo_hits)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_coverage_memo);
+
+namespace {
+void minimize_coverage_keep_target(const string&) {
+    size_t calls = 0;
+    // Every element takes the buggy branch.
+    auto trial = shrink::minimize_coverage(
+        vector<int> {150, 200},
+        subject,
+        Oracle {&calls},
+        shrink::CoverageOptions {
+            .keep_target = true,
+            .trust_target = true,
+            .hit_counts = false,
+        });
+    vector<int> expected = {101};
+    TESTA_ASSERT(trial.value == expected && calls == 0)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("calls: {}", calls)
+        .issue();
+    TESTA_ASSERT(trial.off_target > 0)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_coverage_keep_target);
@@ -0,0 +1,132 @@
+#include "shrink/core.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/extents.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+filesystem::path write_file(const string& case_name, const vector<uint32_t>& xs) {
+    auto path = filesystem::temp_directory_path() / format("{}.bin", case_name);
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(xs.data()), xs.size() * sizeof(uint32_t));
+    return path;
+}
+
+vector<uint32_t> to_vector(const shrink::Extents<uint32_t>& xs) {
+    vector<uint32_t> res;
+    xs.for_each_chunk([&](span<const uint32_t> chunk) {
+        res.insert(res.end(), chunk.begin(), chunk.end());
+    });
+    return res;
+}
+
+void extents_as_len_shrinker(const string& case_name) {
+    vector<uint32_t> xs = {3, 0, 1, 4, 1};
+    auto path = write_file(case_name, xs);
+    auto trial = shrink::Extents<uint32_t>::open(path);
+    TESTA_ASSERT(trial.has_value() && trial->size() == xs.size())
+        .issue();
+    vector<string> trial_res;
+    for(auto const& cand: shrink::shrink(*trial)) {
+        trial_res.push_back(format("[{}]", join(to_vector(cand), ", "sv)));
+    }
+    vector<string> oracle_res;
+    for(auto const& cand: shrink::_impl_vec::LenShrinker<uint32_t>(xs)) {
+        oracle_res.push_back(format("[{}]", join(cand, ", "sv)));
+    }
+    filesystem::remove(path);
+    auto trial_str = join(trial_res, " "sv);
+    auto oracle_str = join(oracle_res, " "sv);
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(extents_as_len_shrinker);
+
+namespace {
+void minimize_extents(const string& case_name) {
+    vector<uint32_t> xs(1000);
+    for(size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = i;
+    }
+    auto path = write_file(case_name, xs);
+    auto init = shrink::Extents<uint32_t>::open(path, shrink::ExtentsOptions {.memory_budget = 64});
+    TESTA_ASSERT(init.has_value())
+        .issue();
+    size_t max_chunk = 0;
+    // fails iff both 42 and 777 are there.
+    auto pred = [&](const shrink::Extents<uint32_t>& v) {
+        bool x = false;
+        bool y = false;
+        v.for_each_chunk([&](span<const uint32_t> chunk) {
+            max_chunk = max(max_chunk, chunk.size());
+            x = x || ranges::find(chunk, 42u) != chunk.end();
+            y = y || ranges::find(chunk, 777u) != chunk.end();
+            return !(x && y);
+        });
+        return x && y;
+    };
+    auto trial = shrink::minimize(*init, pred);
+    auto resumed = shrink::minimize(*init, pred, shrink::MinimizeOptions {.resume = true});
+    vector<uint32_t> oracle = {42, 777};
+    auto trial_xs = to_vector(trial.value);
+    TESTA_ASSERT(trial_xs == oracle && trial.value.extents().size() == 2)
+        .hint("trial: {}", join(trial_xs, ", "sv))
+        .issue();
+    auto resumed_xs = to_vector(resumed.value);
+    TESTA_ASSERT(resumed_xs == oracle)
+        .hint("resumed: {}", join(resumed_xs, ", "sv))
+        .issue();
+    TESTA_ASSERT(max_chunk == 16)
+        .hint("max chunk: {}", max_chunk)
+        .issue();
+
+    auto out = filesystem::temp_directory_path() / format("{}.out.bin", case_name);
+    TESTA_ASSERT(trial.value.write(out))
+        .issue();
+    auto written = shrink::Extents<uint32_t>::open(out);
+    filesystem::remove(out);
+    filesystem::remove(path);
+    TESTA_ASSERT(written.has_value() && to_vector(*written) == oracle)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_extents);
+
+namespace {
+void extents_open_malformed(const string& case_name) {
+    auto path = filesystem::temp_directory_path() / format("{}.bin", case_name);
+    {
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write("12345", 5);
+    }
+    auto trial = shrink::Extents<uint32_t>::open(path);
+    filesystem::remove(path);
+    TESTA_ASSERT(!trial.has_value())
+        .issue();
+
+    auto empty = write_file(case_name, {});
+    auto nothing = shrink::Extents<uint32_t>::open(empty);
+    filesystem::remove(empty);
+    TESTA_ASSERT(nothing.has_value() && nothing->empty())
+        .issue();
+    auto candidates = shrink::shrink(*nothing);
+    TESTA_ASSERT(candidates.begin() == candidates.end())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(extents_open_malformed);
@@ -0,0 +1,88 @@
+#include "shrink/core.hpp"
+#include "shrink/float.hpp"
+#include "shrink/minimize.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+void shrink_double(const string&) {
+    auto trial = shrink::shrink(-2.75);
+    vector<double> trial_res;
+    ranges::copy(trial, back_inserter(trial_res));
+    vector<double> oracle = {0, 1, -1, 2.75, -2, -2.5, -1.375};
+    TESTA_ASSERT(trial_res == oracle)
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_double);
+
+namespace {
+void shrink_double_special(const string&) {
+    auto zero = shrink::shrink(0.0);
+    TESTA_ASSERT(zero.begin() == zero.end())
+        .issue();
+    auto trial = shrink::shrink(numeric_limits<double>::quiet_NaN());
+    vector<double> trial_res;
+    ranges::copy(trial, back_inserter(trial_res));
+    double inf = numeric_limits<double>::infinity();
+    vector<double> oracle = {0, 1, -1, inf, -inf};
+    TESTA_ASSERT(trial_res == oracle)
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_double_special);
+
+namespace {
+void minimize_double(const string&) {
+    auto trial = shrink::minimize(1234.5678, [](double x) {
+        return x > 3.7;
+    });
+    TESTA_ASSERT(trial.value == 4.0)
+        .hint("trial: {}", trial.value)
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls < 100)
+        .hint("predicate calls: {}", trial.stats.predicate_calls)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_double);
+
+namespace {
+void minimize_double_denormal(const string&) {
+    auto trial = shrink::minimize(numeric_limits<double>::denorm_min() * 12345, [](double x) {
+        return x > 0 && x < 1;
+    });
+    TESTA_ASSERT(trial.value == 0.5)
+        .hint("trial: {}", trial.value)
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls < 100)
+        .hint("predicate calls: {}", trial.stats.predicate_calls)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_double_denormal);
+
+namespace {
+void minimize_float_nan(const string&) {
+    auto trial = shrink::minimize(numeric_limits<float>::quiet_NaN(), [](float x) {
+        return !isfinite(x);
+    });
+    TESTA_ASSERT(trial.value == numeric_limits<float>::infinity())
+        .hint("trial: {}", trial.value)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_float_nan);
@@ -4,6 +4,7 @@
 #include "testa.hpp"
 #include <iterator>
 #include <algorithm>
+#include <array>
 #include <cstddef>
 
 using namespace std;
@@ -117,3 +118,19 @@ void shrink_byte(const string&) {
 }
 }
 TESTA_DEF_JUNIT_LIKE1(shrink_byte);
+
+namespace {
+void candidate_table_int(const string&) {
+    static constexpr auto kTable = shrink::candidate_table<100>();
+    static_assert(kTable == array<int, 7>{0, 50, 75, 88, 94, 97, 99});
+    static_assert(shrink::candidate_table<int8_t(0)>().empty());
+
+    vector<int> trial_res;
+    ranges::copy(shrink::shrink(100), std::back_inserter(trial_res));
+    TESTA_ASSERT(ranges::equal(trial_res, kTable))
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(kTable, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(candidate_table_int);
@@ -0,0 +1,163 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <span>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+void minimize_vec(const string&) {
+    vector<int> xs = {3, 14, 15, 92, 65, 35};
+    auto trial = shrink::minimize(xs, [](const vector<int>& xs) {
+        return ranges::any_of(xs, [](int x) { return x >= 50; });
+    });
+    vector<int> oracle = {50};
+    TESTA_ASSERT(trial.value == oracle)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_vec);
+
+namespace {
+void minimize_checkpoint_resume(const string& case_name) {
+    auto path = filesystem::temp_directory_path() / format("{}.ckpt", case_name);
+    filesystem::remove(path);
+    vector<int> xs = {3, 14, 15, 92, 65, 35};
+    auto pred = [](const vector<int>& xs) {
+        return ranges::any_of(xs, [](int x) { return x >= 50; });
+    };
+    auto oracle = shrink::minimize(xs, pred);
+
+    // preempts the first run after a few predicate calls.
+    size_t budget = 7;
+    auto preempted = shrink::minimize(
+        xs,
+        [&](const vector<int>& xs) {
+            if (budget == 0) {
+                // a preempted job evaluates nothing any more.
+                return false;
+            }
+            --budget;
+            return pred(xs);
+        },
+        shrink::MinimizeOptions {
+            .checkpoint_path = path,
+            .checkpoint_interval = 1,
+        });
+    auto ckpt = shrink::load_checkpoint<vector<int>>(path);
+    TESTA_ASSERT(ckpt.has_value())
+        .issue();
+    // rewinds the checkpoint to where the budget ran out.
+    ckpt->position -= preempted.stats.predicate_calls - 7;
+    ckpt->stats.predicate_calls = 7;
+    shrink::save_checkpoint(path, *ckpt);
+
+    size_t resumed_calls = 0;
+    auto trial = shrink::minimize(
+        xs,
+        [&](const vector<int>& xs) {
+            ++resumed_calls;
+            return pred(xs);
+        },
+        shrink::MinimizeOptions {
+            .checkpoint_path = path,
+        });
+    filesystem::remove(path);
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(resumed_calls + 7 == oracle.stats.predicate_calls)
+        .hint("resumed: {}", resumed_calls)
+        .hint("oracle: {}", oracle.stats.predicate_calls)
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls == oracle.stats.predicate_calls)
+        .hint("trial: {}", trial.stats.predicate_calls)
+        .hint("oracle: {}", oracle.stats.predicate_calls)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_checkpoint_resume);
+
+namespace {
+void minimize_resume(const string&) {
+    vector<int> xs;
+    for(int i = 0; i < 200; ++i) {
+        xs.push_back(i % 7 == 0 ? 60 + i : i % 50);
+    }
+    auto pred = [](const vector<int>& xs) {
+        return ranges::count_if(xs, [](int x) { return x >= 50; }) >= 3;
+    };
+    auto oracle = shrink::minimize(xs, pred);
+    auto trial = shrink::minimize(xs, pred, shrink::MinimizeOptions {.resume = true});
+    vector<int> expect = {50, 50, 50};
+    TESTA_ASSERT(trial.value == expect)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(oracle.value == expect)
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls < oracle.stats.predicate_calls)
+        .hint("trial: {}", trial.stats.predicate_calls)
+        .hint("oracle: {}", oracle.stats.predicate_calls)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_resume);
+
+namespace {
+void minimize_replay(const string&) {
+    vector<int> xs;
+    for(int i = 0; i < 200; ++i) {
+        xs.push_back(i % 7 == 0 ? 60 + i : i % 50);
+    }
+    auto pred = [](const vector<int>& xs) {
+        return ranges::count_if(xs, [](int x) { return x >= 50; }) >= 3;
+    };
+    for(bool resume: {false, true}) {
+        shrink::MinimizeOptions opts {.resume = resume};
+        auto oracle = shrink::minimize(xs, pred, opts);
+        TESTA_ASSERT(oracle.decisions.positions.size() == oracle.stats.accepted)
+            .hint("decisions: {}", oracle.decisions.positions.size())
+            .hint("accepted: {}", oracle.stats.accepted)
+            .issue();
+
+        vector<byte> buf;
+        shrink::Serializer<shrink::DecisionLog>::write(buf, oracle.decisions);
+        span<const byte> in(buf);
+        auto log = shrink::Serializer<shrink::DecisionLog>::read(in);
+        TESTA_ASSERT(log && *log == oracle.decisions && in.empty())
+            .hint("resume: {}", resume)
+            .issue();
+
+        auto trial = shrink::replay(xs, *log, opts);
+        TESTA_ASSERT(trial && *trial == oracle.value)
+            .hint("resume: {}", resume)
+            .hint("trial: {}", trial ? join(*trial, ", "sv) : "none"s)
+            .hint("oracle: {}", join(oracle.value, ", "sv))
+            .issue();
+    }
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_replay);
+
+namespace {
+void minimize_replay_misfit(const string&) {
+    vector<int> xs = {3, 14, 15, 92, 65, 35};
+    shrink::DecisionLog log {.positions = {1000}};
+    auto trial = shrink::replay(xs, log);
+    TESTA_ASSERT(!trial)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_replay_misfit);
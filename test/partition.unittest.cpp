@@ -0,0 +1,72 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/partition.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+// 10 partitions, by hundreds, of 8 elements each.
+vector<int> batch() {
+    vector<int> res;
+    for(int i = 0; i < 80; ++i) {
+        res.push_back(i % 10 * 100 + i * 7 % 100);
+    }
+    return res;
+}
+
+void minimize_partitioned(const string&) {
+    auto pred = [](const vector<int>& xs) {
+        return ranges::any_of(xs, [](int x) { return x >= 350 && x < 400; })
+            && ranges::any_of(xs, [](int x) { return x >= 760 && x < 800; });
+    };
+    auto trial = shrink::minimize_partitioned(
+        batch(),
+        [](int x) { return x / 100; },
+        pred,
+        shrink::PartitionOptions {.threads = 2});
+    vector<int> oracle = {350, 760};
+    TESTA_ASSERT(trial.value == oracle)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.partitions == 10 && trial.needed == 2 && trial.independent)
+        .hint("partitions: {}", trial.partitions)
+        .hint("needed: {}", trial.needed)
+        .hint("independent: {}", trial.independent)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_partitioned);
+
+namespace {
+void minimize_partitioned_dependent(const string&) {
+    // Every partition shrinks on its own assuming the others are as they
+    // are, so the merge does not fail.
+    auto pred = [](const vector<int>& xs) {
+        return accumulate(xs.begin(), xs.end(), 0) >= 85;
+    };
+    auto trial = shrink::minimize_partitioned(
+        vector<int> {10, 20, 10, 20, 10, 20},
+        [](int x) { return x / 10; },
+        pred);
+    TESTA_ASSERT(!trial.independent)
+        .issue();
+    TESTA_ASSERT(pred(trial.value))
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .issue();
+    auto oracle = shrink::minimize(trial.value, pred);
+    TESTA_ASSERT(oracle.value == trial.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_partitioned_dependent);
@@ -0,0 +1,112 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/adaptor.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/passes.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+template<class R>
+string candidates_str(const R& trial) {
+    vector<string> res;
+    ranges::copy(
+        trial
+        | views::transform([](auto const& xs) {
+            return format("[{}]", join(xs, ", "sv));
+        }),
+        back_inserter(res));
+    return join(res, ", "sv);
+}
+
+void vec_passes_as_shrink(const string&) {
+    vector<int> xs = {3, 0, 1, 4};
+    auto trial_str = candidates_str(
+        shrink::vec_passes(xs, shrink::removal_pass, shrink::elem_pass));
+    auto oracle_str = candidates_str(shrink::shrink(xs));
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(vec_passes_as_shrink);
+
+namespace {
+void vec_passes_lazy(const string&) {
+    size_t calls = 0;
+    // sorts the vector if it is not sorted.
+    auto sort_pass = [&](const vector<int>& xs) {
+        ++calls;
+        vector<vector<int>> res;
+        if (!ranges::is_sorted(xs)) {
+            res.push_back(xs);
+            ranges::sort(res.back());
+        }
+        return res;
+    };
+    auto trial = shrink::vec_passes(
+        vector<int> {2, 1},
+        shrink::removal_pass,
+        sort_pass,
+        shrink::elem_pass);
+    auto it = trial.begin();
+    TESTA_ASSERT(calls == 0 && it.pass_name() == "len"sv)
+        .hint("calls: {}", calls)
+        .issue();
+    auto trial_str = candidates_str(trial);
+    auto oracle_str = "[1], [2], [1, 2], [0, 1], [1, 1], [2, 0]"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(vec_passes_lazy);
+
+namespace {
+struct Sorted {
+    vector<int> xs;
+};
+}
+
+template<>
+struct shrink::Shrinker<Sorted> {
+    explicit Shrinker(Sorted v) noexcept
+    :   _v(std::move(v))
+    {}
+
+    auto shrink() && noexcept {
+        // Removal keeps a vector sorted, while shrinking an element may not.
+        return shrink::map(
+            shrink::vec_passes(std::move(_v.xs), shrink::removal_pass),
+            [](vector<int> xs) { return Sorted {.xs = std::move(xs)}; });
+    }
+
+private:
+    Sorted _v;
+};
+
+static_assert(shrink::Shrinkable<Sorted>);
+
+namespace {
+void minimize_vec_passes(const string&) {
+    auto trial = shrink::minimize(Sorted {.xs = {1, 4, 6, 9, 12}}, [](const Sorted& v) {
+        return ranges::count_if(v.xs, [](int x) { return x % 3 == 0; }) >= 2;
+    });
+    vector<int> oracle = {9, 12};
+    TESTA_ASSERT(trial.value.xs == oracle)
+        .hint("trial: {}", join(trial.value.xs, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_vec_passes);
@@ -0,0 +1,69 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/pipeline.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+void minimize_pipelined_as_minimize(const string&) {
+    vector<int> xs;
+    for(int i = 0; i < 200; ++i) {
+        xs.push_back(i % 7 == 0 ? 60 + i : i % 50);
+    }
+    auto pred = [](const vector<int>& xs) {
+        return ranges::count_if(xs, [](int x) { return x >= 50; }) >= 3;
+    };
+    auto oracle = shrink::minimize(xs, pred);
+    for(size_t depth: {1, 2, 3}) {
+        auto trial = shrink::minimize_pipelined(xs, pred, shrink::PipelineOptions {.depth = depth});
+        TESTA_ASSERT(trial.value == oracle.value)
+            .hint("depth: {}", depth)
+            .hint("trial: {}", join(trial.value, ", "sv))
+            .hint("oracle: {}", join(oracle.value, ", "sv))
+            .issue();
+        TESTA_ASSERT(trial.decisions == oracle.decisions)
+            .hint("depth: {}", depth)
+            .issue();
+        TESTA_ASSERT(trial.stats.predicate_calls == oracle.stats.predicate_calls)
+            .hint("depth: {}", depth)
+            .hint("trial: {}", trial.stats.predicate_calls)
+            .hint("oracle: {}", oracle.stats.predicate_calls)
+            .issue();
+    }
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_pipelined_as_minimize);
+
+namespace {
+void minimize_pipelined_nested(const string&) {
+    vector<vector<int>> xss = {{3, 14}, {15, 92, 65}, {35}};
+    auto pred = [](const vector<vector<int>>& xss) {
+        return ranges::any_of(xss, [](const vector<int>& xs) {
+            return ranges::count_if(xs, [](int x) { return x >= 50; }) >= 2;
+        });
+    };
+    auto oracle = shrink::minimize(xss, pred);
+    auto trial = shrink::minimize_pipelined(xss, pred);
+    TESTA_ASSERT(trial.value == oracle.value && trial.decisions == oracle.decisions)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_pipelined_nested);
+
+namespace {
+void minimize_pipelined_int(const string&) {
+    auto trial = shrink::minimize_pipelined(1000, [](int x) { return x >= 37; });
+    TESTA_ASSERT(trial.value == 37)
+        .hint("trial: {}", trial.value)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_pipelined_int);
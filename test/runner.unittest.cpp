@@ -0,0 +1,85 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/runner.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+bool all_small(const vector<int>& xs) {
+    return ranges::all_of(xs, [](int x) { return x < 50; });
+}
+
+void check_parallel_reproducible(const string&) {
+    auto trial = shrink::check<vector<int>>(
+        all_small,
+        shrink::CheckOptions {
+            .seed = 42,
+            .cases = 1000,
+            .threads = 4,
+        });
+    auto oracle = shrink::check<vector<int>>(
+        all_small,
+        shrink::CheckOptions {
+            .seed = 42,
+            .cases = 1000,
+            .threads = 1,
+        });
+    TESTA_ASSERT(!trial && !oracle)
+        .issue();
+    TESTA_ASSERT(trial.failure->case_index == oracle.failure->case_index)
+        .hint("trial: {}", *trial.failure->case_index)
+        .hint("oracle: {}", *oracle.failure->case_index)
+        .issue();
+    auto reproduced = shrink::generate_case<vector<int>>(42, *trial.failure->case_index, 100);
+    TESTA_ASSERT(reproduced == trial.failure->original)
+        .hint("reproduced: {}", join(reproduced, ", "sv))
+        .hint("original: {}", join(trial.failure->original, ", "sv))
+        .issue();
+    vector<int> minimized_oracle = {50};
+    TESTA_ASSERT(trial.failure->minimized.value == minimized_oracle)
+        .hint("trial: {}", join(trial.failure->minimized.value, ", "sv))
+        .hint("oracle: {}", join(minimized_oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(check_parallel_reproducible);
+
+namespace {
+void check_replays_corpus_first(const string& case_name) {
+    auto path = filesystem::temp_directory_path() / format("{}.corpus", case_name);
+    filesystem::remove(path);
+    auto first = shrink::check<vector<int>>(
+        all_small,
+        shrink::CheckOptions {
+            .seed = 42,
+            .cases = 1000,
+            .corpus_path = path,
+        });
+    TESTA_ASSERT(!first && first.failure->case_index.has_value())
+        .issue();
+    // the minimized failure is recorded, so it is replayed before any random
+    // case.
+    auto trial = shrink::check<vector<int>>(
+        all_small,
+        shrink::CheckOptions {
+            .seed = 42,
+            .cases = 1000,
+            .corpus_path = path,
+        });
+    filesystem::remove(path);
+    TESTA_ASSERT(!trial && trial.failure->corpus_index == 0)
+        .issue();
+    TESTA_ASSERT(trial.cases_run == 0)
+        .hint("cases run: {}", trial.cases_run)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(check_replays_corpus_first);
@@ -0,0 +1,44 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/schedule.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+void minimize_adaptive_defers(const string&) {
+    vector<int> xs(200);
+    for(size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = (i * 37) % 1000;
+    }
+    auto pred = [](const vector<int>& xs) {
+        return ranges::count_if(xs, [](int x) { return x >= 500; }) >= 10;
+    };
+    auto oracle = shrink::minimize(xs, pred);
+    auto trial = shrink::minimize_adaptive(xs, pred);
+    TESTA_ASSERT(trial.value == oracle.value)
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle.value, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls < oracle.stats.predicate_calls)
+        .hint("trial: {}", trial.stats.predicate_calls)
+        .hint("oracle: {}", oracle.stats.predicate_calls)
+        .issue();
+    size_t arm_calls = 0;
+    for(auto const& arm: trial.arms) {
+        arm_calls += arm.trials;
+    }
+    TESTA_ASSERT(arm_calls == trial.stats.predicate_calls)
+        .hint("arms: {}", arm_calls)
+        .hint("total: {}", trial.stats.predicate_calls)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_adaptive_defers);
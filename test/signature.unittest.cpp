@@ -0,0 +1,76 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/signature.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+
+namespace {
+// Long vectors fail at one site, and short ones with a big element at
+// another one.
+optional<shrink::Signature> two_bugs(const vector<int>& xs) {
+    if (xs.size() >= 4) {
+        return shrink::signature_of("long");
+    }
+    if (ranges::any_of(xs, [](int x) { return x >= 50; })) {
+        return shrink::signature_of("big");
+    }
+    return nullopt;
+}
+}
+
+namespace {
+void minimize_keeps_signature(const string&) {
+    shrink::SignatureShrinker<vector<int>, decltype(&two_bugs)> shrinker(&two_bugs);
+    auto trial = shrinker.minimize({3, 14, 15, 92, 65, 35});
+    vector<int> oracle = {0, 0, 0, 0};
+    TESTA_ASSERT(trial.value == oracle && trial.signature == shrink::signature_of("long"))
+        .hint("trial: {}", join(trial.value, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_keeps_signature);
+
+namespace {
+void minimize_slipped_signature(const string&) {
+    shrink::SignatureShrinker<vector<int>, decltype(&two_bugs)> shrinker(&two_bugs);
+    shrinker.minimize({3, 14, 15, 92, 65, 35});
+    auto big = shrink::signature_of("big");
+    TESTA_ASSERT(shrinker.slipped().size() == 1 && shrinker.slipped().contains(big))
+        .hint("slipped: {}", shrinker.slipped().size())
+        .issue();
+
+    size_t evaluations = shrinker.evaluations();
+    auto trial = shrinker.minimize_slipped(big);
+    TESTA_ASSERT(trial.has_value())
+        .issue();
+    vector<int> oracle = {50};
+    TESTA_ASSERT(trial->value == oracle && trial->signature == big)
+        .hint("trial: {}", join(trial->value, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+    // Candidates met while minimizing the first target are not evaluated
+    // again.
+    TESTA_ASSERT(trial->memo_hits > 0)
+        .hint("memo hits: {}", trial->memo_hits)
+        .issue();
+    TESTA_ASSERT(shrinker.evaluations() - evaluations + trial->memo_hits == trial->stats.predicate_calls)
+        .hint("evaluations: {}", shrinker.evaluations() - evaluations)
+        .hint("memo hits: {}", trial->memo_hits)
+        .hint("predicate calls: {}", trial->stats.predicate_calls)
+        .issue();
+    TESTA_ASSERT(shrinker.slipped().empty())
+        .issue();
+    TESTA_ASSERT(!shrinker.minimize_slipped(big).has_value())
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_slipped_signature);
@@ -6,6 +6,7 @@
 #include <ranges>
 #include <iterator>
 #include <algorithm>
+#include <array>
 #include <format>
 
 using namespace std;
@@ -34,3 +35,20 @@ void shrink_span(const string&) {
 }
 }
 TESTA_DEF_JUNIT_LIKE1(shrink_span);
+
+namespace {
+constexpr array<int, 4> kSpanElems = {1, 2, 3, 4};
+
+void shrink_span_constexpr(const string&) {
+    // holes of 2 elements (3 of them), then of 3 elements (2 of them).
+    static_assert(shrink::candidate_count(span<const int>(kSpanElems)) == 5);
+    static_assert([]() {
+        auto xs = shrink::shrink(span<const int>(kSpanElems));
+        auto first = *xs.begin();
+        return first.size() == 2 && first.front() == 1;
+    }());
+    TESTA_ASSERT(shrink::candidate_count(span<const int>(kSpanElems)) == 5)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_span_constexpr);
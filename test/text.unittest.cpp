@@ -0,0 +1,103 @@
+#include "shrink/core.hpp"
+#include "shrink/text.hpp"
+#include "shrink/minimize.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <ranges>
+#include <iterator>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+string candidates_str(const shrink::Text& t) {
+    vector<string> res;
+    ranges::copy(
+        shrink::shrink(t)
+        | views::transform([](auto const& x) {
+            return x.str;
+        }),
+        back_inserter(res));
+    return join(res, " | "sv);
+}
+
+void shrink_text_json(const string&) {
+    auto t = shrink::text(R"({"a": [1, 2, 3], "b": "xy"})", shrink::TextGrammar::json());
+    auto trial_str = candidates_str(t);
+    auto oracle_str =
+        R"({} | { "b": "xy"} | {"a": [1, 2, 3]} | {"a": [], "b": "xy"})"
+        R"( | {"a": [1, 3], "b": "xy"} | {"a": [1, 2], "b": "xy"} | {"a": [ 2, 3], "b": "xy"})"
+        R"( | {"a": [1, 2, 3], "b": ""} | {"": [1, 2, 3], "b": "xy"} | {"a": [1, 2, 3], "": "xy"})"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_text_json);
+
+namespace {
+void shrink_text_lines(const string&) {
+    // Equal lines are removed once, and lines which open a bracket without
+    // closing it are kept.
+    auto t = shrink::text("f() {\n  g();\n  g();\n}\n", shrink::TextGrammar::c());
+    auto trial_str = candidates_str(t);
+    auto oracle_str = "f() {}\n | f() {\n  g();\n}\n"sv;
+    TESTA_ASSERT(trial_str == oracle_str)
+        .hint("trial: {}", trial_str)
+        .hint("oracle: {}", oracle_str)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_text_lines);
+
+namespace {
+bool balanced(string_view s) {
+    string stack;
+    bool quoted = false;
+    for(size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (quoted) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == '{' || c == '[') {
+            stack.push_back(c == '{' ? '}' : ']');
+        } else if (c == '}' || c == ']') {
+            if (stack.empty() || stack.back() != c) {
+                return false;
+            }
+            stack.pop_back();
+        }
+    }
+    return !quoted && stack.empty();
+}
+
+void minimize_text_json(const string&) {
+    auto t = shrink::text(
+        R"({"id": 7, "tags": ["x", "y"], "items": [{"n": 1}, {"n": "bad\"q"}, {"n": 3}]})",
+        shrink::TextGrammar::json());
+    size_t unbalanced = 0;
+    auto trial = shrink::minimize(t, [&](const shrink::Text& t) {
+        if (!balanced(t.str)) {
+            ++unbalanced;
+        }
+        return t.str.find(R"("bad\"q")") != string::npos;
+    });
+    auto oracle = R"({ "": [ {"": "bad\"q"}]})"sv;
+    TESTA_ASSERT(trial.value.str == oracle)
+        .hint("trial: {}", trial.value.str)
+        .hint("oracle: {}", oracle)
+        .issue();
+    TESTA_ASSERT(unbalanced == 0)
+        .hint("unbalanced: {}", unbalanced)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_text_json);
@@ -0,0 +1,75 @@
+#include "shrink/core.hpp"
+#include "shrink/int.hpp"
+#include "shrink/vec.hpp"
+#include "shrink/minimize.hpp"
+#include "shrink/trace.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <format>
+
+using namespace std;
+
+static_assert(is_empty_v<shrink::NullTracer>);
+
+namespace {
+void trace_minimize(const string&) {
+    vector<int> xs = {3, 14, 15, 92, 65, 35};
+    shrink::RecordingTracer tracer;
+    auto trial = shrink::minimize(
+        xs,
+        [](const vector<int>& xs) {
+            return ranges::any_of(xs, [](int x) { return x >= 50; });
+        },
+        shrink::MinimizeOptions {},
+        tracer);
+    auto count = [&](shrink::TracePhase phase, bool accepted_only) {
+        return static_cast<size_t>(ranges::count_if(
+            tracer.events(),
+            [&](const shrink::TraceEvent& ev) {
+                return ev.phase == phase && (!accepted_only || ev.accepted);
+            }));
+    };
+    using shrink::TracePhase;
+    TESTA_ASSERT(count(TracePhase::kPredicate, false) == trial.stats.predicate_calls)
+        .hint("events: {}", count(TracePhase::kPredicate, false))
+        .hint("calls: {}", trial.stats.predicate_calls)
+        .issue();
+    TESTA_ASSERT(count(TracePhase::kPredicate, true) == trial.stats.accepted)
+        .hint("events: {}", count(TracePhase::kPredicate, true))
+        .hint("accepted: {}", trial.stats.accepted)
+        .issue();
+    TESTA_ASSERT(count(TracePhase::kConstruct, false) == trial.stats.predicate_calls)
+        .issue();
+    // every accepting round, and the last one where nothing is accepted.
+    TESTA_ASSERT(count(TracePhase::kRound, false) == trial.stats.accepted + 1)
+        .hint("rounds: {}", count(TracePhase::kRound, false))
+        .issue();
+    TESTA_ASSERT(ranges::any_of(tracer.events(), [](const shrink::TraceEvent& ev) {
+            return ev.pass == "len";
+        }))
+        .issue();
+    TESTA_ASSERT(ranges::any_of(tracer.events(), [](const shrink::TraceEvent& ev) {
+            return ev.pass == "elem";
+        }))
+        .issue();
+
+    for(auto const& row: tracer.summary()) {
+        TESTA_ASSERT(row.p50_ns <= row.p99_ns)
+            .hint("phase: {}", shrink::trace_phase_name(row.phase))
+            .hint("pass: {}", row.pass)
+            .issue();
+    }
+
+    auto json = tracer.chrome_trace();
+    TESTA_ASSERT(json.starts_with("{\"traceEvents\":[{\"name\":\"step\",\"cat\":\"len\""))
+        .hint("json: {}", json.substr(0, 80))
+        .issue();
+    TESTA_ASSERT(json.ends_with("],\"displayTimeUnit\":\"ns\"}"))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(trace_minimize);
@@ -34,6 +34,58 @@ void shrink_vec(const string&) {
 }
 TESTA_DEF_JUNIT_LIKE1(shrink_vec);
 
+namespace {
+void shrink_vec_from_hint(const string&) {
+    vector<uint8_t> xs = {1, 1};
+    auto str = [](auto&& trial) {
+        vector<string> res;
+        ranges::copy(
+            trial
+            | views::transform([](auto const& xs) {
+                return format("[{}]", join(xs, ", "sv));
+            }),
+            back_inserter(res));
+        return join(res, ", "sv);
+    };
+    using Position = shrink::_impl_vec::Position;
+    {
+        auto trial_str = str(shrink::Shrinker<vector<uint8_t>>(xs).shrink(Position {
+            .pass = Position::Pass::kLen,
+            .hole = {.offset = 1, .len = 1},
+        }));
+        auto oracle_str = "[1], [0, 1], [1, 0], [1]"sv;
+        TESTA_ASSERT(trial_str == oracle_str)
+            .hint("trial: {}", trial_str)
+            .hint("oracle: {}", oracle_str)
+            .issue();
+    }
+    {
+        auto trial_str = str(shrink::Shrinker<vector<uint8_t>>(xs).shrink(Position {
+            .pass = Position::Pass::kElem,
+            .index = 1,
+        }));
+        auto oracle_str = "[1, 0], [1], [1], [0, 1]"sv;
+        TESTA_ASSERT(trial_str == oracle_str)
+            .hint("trial: {}", trial_str)
+            .hint("oracle: {}", oracle_str)
+            .issue();
+    }
+    {
+        // nothing from a hint beyond the end, so it starts over.
+        auto trial_str = str(shrink::Shrinker<vector<uint8_t>>(xs).shrink(Position {
+            .pass = Position::Pass::kElem,
+            .index = 5,
+        }));
+        auto oracle_str = "[1], [1], [0, 1], [1, 0]"sv;
+        TESTA_ASSERT(trial_str == oracle_str)
+            .hint("trial: {}", trial_str)
+            .hint("oracle: {}", oracle_str)
+            .issue();
+    }
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_vec_from_hint);
+
 namespace {
 void shrink_elem_shrinker_empty(const string&) {
     vector<uint8_t> xs = {0, 0, 0};
@@ -239,3 +291,83 @@ void shrink_dangling_elem_shrinker(const string&) {
 }
 }
 TESTA_DEF_JUNIT_LIKE1(shrink_dangling_elem_shrinker);
+
+namespace {
+struct Counted {
+    static inline size_t copies = 0;
+
+    int v = 0;
+
+    Counted(int v) noexcept
+    :   v(v)
+    {}
+
+    Counted(const Counted& ano) noexcept
+    :   v(ano.v)
+    {
+        ++copies;
+    }
+
+    Counted(Counted&&) noexcept = default;
+    Counted& operator=(const Counted& ano) noexcept {
+        v = ano.v;
+        ++copies;
+        return *this;
+    }
+    Counted& operator=(Counted&&) noexcept = default;
+};
+}
+
+template<>
+struct shrink::Shrinker<Counted> {
+    explicit Shrinker(Counted) noexcept
+    {}
+
+    shrink::_EmptyShrinkerImpl<Counted> shrink() && noexcept {
+        return shrink::_EmptyShrinkerImpl<Counted>();
+    }
+};
+
+namespace {
+void shrink_nested_vec_without_copies(const string&) {
+    vector<vector<Counted>> xs;
+    xs.push_back({});
+    xs.back().emplace_back(1);
+    xs.back().emplace_back(2);
+    xs.push_back({});
+    xs.back().emplace_back(3);
+    Counted::copies = 0;
+    auto trial = shrink::shrink(std::move(xs));
+    size_t candidates = 0;
+    for(auto it = trial.begin(); it != trial.end(); ++it) {
+        ++candidates;
+    }
+    // Walking through candidates without materializing them copies only the
+    // innermost elements, which their shrinkers take by value.
+    TESTA_ASSERT(Counted::copies == 3)
+        .hint("copies: {}", Counted::copies)
+        .hint("candidates: {}", candidates)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_nested_vec_without_copies);
+
+namespace {
+void shrink_vec_materialize(const string&) {
+    vector<vector<int>> xss = {{3, 1}, {}, {4, 1, 5}};
+    auto trial = shrink::shrink(xss);
+    // One buffer for all candidates, so it is reused.
+    vector<vector<int>> buf;
+    size_t n = 0;
+    for(auto it = trial.begin(); it != trial.end(); ++it, ++n) {
+        it.materialize(buf);
+        auto oracle = *it;
+        TESTA_ASSERT(buf == oracle)
+            .hint("candidate: {}", n)
+            .issue();
+    }
+    TESTA_ASSERT(n > 0)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_vec_materialize);
@@ -0,0 +1,96 @@
+#include "shrink/core.hpp"
+#include "shrink/wide.hpp"
+#include "shrink/minimize.hpp"
+#include "test_util.hpp"
+#include "testa.hpp"
+#include <string>
+#include <vector>
+#include <array>
+#include <ranges>
+#include <iterator>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+namespace {
+string format_u128(shrink::uint128_t x) {
+    return format("{:x}:{:x}",
+        static_cast<uint64_t>(x >> 64),
+        static_cast<uint64_t>(x));
+}
+
+void shrink_uint128(const string&) {
+    shrink::uint128_t x = (shrink::uint128_t(1) << 64) | 6;
+    vector<string> trial_res;
+    ranges::copy(
+        shrink::shrink(x) | views::transform(format_u128),
+        back_inserter(trial_res));
+    vector<string> oracle = {"0:0", "0:6", "1:0", "1:1", "1:3", "1:5"};
+    TESTA_ASSERT(trial_res == oracle)
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_uint128);
+
+namespace {
+void shrink_int128_neg(const string&) {
+    shrink::int128_t x = -10;
+    vector<int64_t> trial_res;
+    ranges::copy(
+        shrink::shrink(x) | views::transform([](shrink::int128_t x) {
+            return static_cast<int64_t>(x);
+        }),
+        back_inserter(trial_res));
+    vector<int64_t> oracle = {0, -1, -5, -8, -9};
+    TESTA_ASSERT(trial_res == oracle)
+        .hint("trial: {}", join(trial_res, ", "sv))
+        .hint("oracle: {}", join(oracle, ", "sv))
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(shrink_int128_neg);
+
+namespace {
+struct U256 {
+    array<uint64_t, 4> words;
+};
+}
+
+template<>
+struct shrink::WideInt<U256> {
+    static constexpr size_t kWords = 4;
+    static constexpr bool kSigned = false;
+
+    static array<uint64_t, 4> to_words(const U256& v) noexcept {
+        return v.words;
+    }
+
+    static U256 from_words(const array<uint64_t, 4>& ws) noexcept {
+        return U256 {.words = ws};
+    }
+};
+
+namespace {
+void minimize_u256(const string&) {
+    U256 x {.words = {
+        0x0123456789abcdefULL,
+        0xfedcba9876543210ULL,
+        0x0f1e2d3c4b5a6978ULL,
+        0x8877665544332211ULL,
+    }};
+    auto trial = shrink::minimize(x, [](const U256& v) {
+        return v.words[3] != 0;
+    });
+    array<uint64_t, 4> oracle = {0, 0, 0, 1};
+    TESTA_ASSERT(trial.value.words == oracle)
+        .hint("trial: {}", join(trial.value.words, ", "sv))
+        .issue();
+    TESTA_ASSERT(trial.stats.predicate_calls <= 16)
+        .hint("predicate calls: {}", trial.stats.predicate_calls)
+        .issue();
+}
+}
+TESTA_DEF_JUNIT_LIKE1(minimize_u256);